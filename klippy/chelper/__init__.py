@@ -19,6 +19,7 @@ SSE_FLAGS = "-mfpmath=sse -msse2"
 SOURCE_FILES = [
     'pyhelper.c', 'serialqueue.c', 'stepcompress.c', 'steppersync.c',
     'itersolve.c', 'trapq.c', 'pollreactor.c', 'msgblock.c', 'trdispatch.c',
+    'bulkqueue.c', 'msgparse.c', 'reactor.c', 'gcodeparse.c', 'lookahead.c',
     'kin_cartesian.c', 'kin_corexy.c', 'kin_corexz.c', 'kin_delta.c',
     'kin_deltesian.c', 'kin_polar.c', 'kin_rotary_delta.c', 'kin_winch.c',
     'kin_extruder.c', 'kin_shaper.c', 'kin_idex.c', 'kin_generic.c'
@@ -35,10 +36,17 @@ defs_stepcompress = """
         int64_t start_position;
         int step_count, interval, add;
     };
+    struct stepcompress_stats {
+        uint64_t step_count, queue_step_count;
+    };
 
     void stepcompress_fill(struct stepcompress *sc, uint32_t oid
         , uint32_t max_error, int32_t queue_step_msgtag
         , int32_t set_next_step_dir_msgtag);
+    void stepcompress_set_delta(struct stepcompress *sc
+        , int32_t queue_step_delta_msgtag);
+    void stepcompress_set_lookahead(struct stepcompress *sc
+        , uint32_t lookahead);
     void stepcompress_set_invert_sdir(struct stepcompress *sc
         , uint32_t invert_sdir);
     int stepcompress_reset(struct stepcompress *sc, uint64_t last_step_clock);
@@ -49,6 +57,10 @@ defs_stepcompress = """
     int stepcompress_extract_old(struct stepcompress *sc
         , struct pull_history_steps *p, int max
         , uint64_t start_clock, uint64_t end_clock);
+    void stepcompress_get_stats(struct stepcompress *sc
+        , struct stepcompress_stats *s);
+    int64_t stepcompress_replay(uint32_t max_error, uint32_t lookahead
+        , uint64_t *step_clocks, uint8_t *step_dirs, int count);
 """
 
 defs_steppersync = """
@@ -59,18 +71,24 @@ defs_steppersync = """
         struct syncemitter *se);
     void syncemitter_queue_msg(struct syncemitter *se, uint64_t req_clock
         , uint32_t *data, int len);
+    void syncemitter_setup_movequeue(struct syncemitter *se, int move_num);
     struct syncemitter *steppersync_alloc_syncemitter(struct steppersync *ss
         , char name[16], int alloc_stepcompress);
     void steppersync_setup_movequeue(struct steppersync *ss
         , struct serialqueue *sq, int move_num);
+    void steppersync_setup_batching(struct steppersync *ss
+        , int queue_step_msgtag, int queue_steps_msgtag);
     void steppersync_set_time(struct steppersync *ss
         , double time_offset, double mcu_freq);
-    struct steppersyncmgr *steppersyncmgr_alloc(void);
+    struct steppersyncmgr *steppersyncmgr_alloc(int num_threads);
     void steppersyncmgr_free(struct steppersyncmgr *ssm);
+    int steppersyncmgr_get_thread_count(struct steppersyncmgr *ssm);
     struct steppersync *steppersyncmgr_alloc_steppersync(
         struct steppersyncmgr *ssm);
     struct syncemitter *steppersyncmgr_gen_steps(struct steppersyncmgr *ssm
         , double flush_time, double gen_steps_time, double clear_history_time);
+    int32_t syncemitter_bench_gen_steps(struct syncemitter *se
+        , double gen_steps_time, uint64_t flush_clock);
 """
 
 defs_itersolve = """
@@ -96,6 +114,9 @@ defs_trapq = """
         double start_x, start_y, start_z;
         double x_r, y_r, z_r;
     };
+    struct trapq_stats {
+        int live_moves, peak_moves, alloc_moves;
+    };
 
     struct trapq *trapq_alloc(void);
     void trapq_free(struct trapq *tq);
@@ -104,12 +125,14 @@ defs_trapq = """
         , double start_pos_x, double start_pos_y, double start_pos_z
         , double axes_r_x, double axes_r_y, double axes_r_z
         , double start_v, double cruise_v, double accel);
+    void trapq_append_batch(struct trapq *tq, double *data, int count);
     void trapq_finalize_moves(struct trapq *tq, double print_time
         , double clear_history_time);
     void trapq_set_position(struct trapq *tq, double print_time
         , double pos_x, double pos_y, double pos_z);
     int trapq_extract_old(struct trapq *tq, struct pull_move *p, int max
         , double start_time, double end_time);
+    void trapq_get_stats(struct trapq *tq, struct trapq_stats *s);
 """
 
 defs_kin_cartesian = """
@@ -189,7 +212,7 @@ defs_serialqueue = """
     };
 
     struct serialqueue *serialqueue_alloc(int serial_fd, char serial_fd_type
-        , int client_id, char name[16]);
+        , int client_id, char name[16], struct pollreactor_thread *prt);
     void serialqueue_exit(struct serialqueue *sq);
     void serialqueue_free(struct serialqueue *sq);
     struct command_queue *serialqueue_alloc_commandqueue(void);
@@ -203,9 +226,11 @@ defs_serialqueue = """
         , double frequency);
     void serialqueue_set_receive_window(struct serialqueue *sq
         , int receive_window);
+    void serialqueue_set_adaptive_window(struct serialqueue *sq, int enable);
     void serialqueue_set_clock_est(struct serialqueue *sq, double est_freq
         , double conv_time, uint64_t conv_clock);
     void serialqueue_get_stats(struct serialqueue *sq, char *buf, int len);
+    void message_get_stats(uint32_t *alloc_count, uint32_t *pool_count);
     int serialqueue_extract_old(struct serialqueue *sq, int sentq
         , struct pull_queue_message *q, int max);
 """
@@ -223,6 +248,82 @@ defs_trdispatch = """
         , uint64_t expire_ticks, uint64_t min_extend_ticks);
 """
 
+defs_bulkqueue = """
+    #define MESSAGE_PAYLOAD_MAX 59
+    struct pull_bulk_data {
+        uint32_t sequence, len;
+        uint8_t data[MESSAGE_PAYLOAD_MAX];
+    };
+
+    struct bulkqueue *bulkqueue_alloc(void);
+    void bulkqueue_setup(struct bulkqueue *bq, struct serialqueue *sq
+        , uint32_t msgtag, uint32_t oid);
+    int bulkqueue_pull(struct bulkqueue *bq, struct pull_bulk_data *pbd
+        , int max);
+    void bulkqueue_free(struct bulkqueue *bq);
+"""
+
+defs_msgparse = """
+    struct msgparse *msgparse_alloc(void);
+    void msgparse_free(struct msgparse *mp);
+    int msgparse_add_format(struct msgparse *mp, int msgid
+        , char *param_types);
+    int msgparse_parse(struct msgparse *mp, uint8_t *msg, int msg_len
+        , int pos, int64_t *values);
+"""
+
+defs_pollreactor = """
+    struct pollreactor_thread *pollreactor_thread_alloc(char name[16]);
+    void pollreactor_thread_free(struct pollreactor_thread *prt);
+"""
+
+defs_reactor = """
+    struct reactor_poll_result {
+        double eventtime;
+        int fd_count, timer_count;
+        int fds[16], fd_events[16];
+        int timers[32];
+    };
+
+    struct reactor *reactor_alloc(void);
+    void reactor_free(struct reactor *r);
+    void reactor_update_timer(struct reactor *r, int id, double waketime);
+    int reactor_add_timer(struct reactor *r, double waketime);
+    void reactor_remove_timer(struct reactor *r, int id);
+    int reactor_set_fd(struct reactor *r, int fd, int events);
+    int reactor_poll(struct reactor *r, int may_sleep
+        , struct reactor_poll_result *res);
+"""
+
+defs_gcodeparse = """
+    struct gcodeparse_line {
+        uint32_t code, param_mask;
+        double values[26];
+    };
+    int gcodeparse_lines(char *buf, int len, struct gcodeparse_line *lines
+        , int max);
+    int gcodeparse_decode(uint8_t *buf, int len
+        , struct gcodeparse_line *lines, int max, int *offsets);
+"""
+
+defs_lookahead = """
+    struct lookahead_result {
+        double start_v, cruise_v, end_v;
+        double accel_t, cruise_t, decel_t;
+    };
+    struct lookahead *lookahead_alloc(void);
+    void lookahead_free(struct lookahead *la);
+    void lookahead_reset(struct lookahead *la);
+    int lookahead_add_move(struct lookahead *la, int is_kinematic
+        , double move_d, double axes_r_x, double axes_r_y, double axes_r_z
+        , double accel, double junction_deviation
+        , double max_cruise_v2, double delta_v2
+        , double mcr_delta_v2, double extra_v2);
+    void lookahead_limit_next_junction(struct lookahead *la, double v2);
+    int lookahead_flush(struct lookahead *la, int lazy
+        , struct lookahead_result *results);
+"""
+
 defs_pyhelper = """
     void set_python_logging_callback(void (*func)(const char *));
     double get_monotonic(void);
@@ -236,6 +337,8 @@ defs_std = """
 defs_all = [
     defs_pyhelper, defs_serialqueue, defs_std, defs_stepcompress,
     defs_steppersync, defs_itersolve, defs_trapq, defs_trdispatch,
+    defs_bulkqueue, defs_msgparse, defs_pollreactor, defs_reactor,
+    defs_gcodeparse, defs_lookahead,
     defs_kin_cartesian, defs_kin_corexy, defs_kin_corexz, defs_kin_delta,
     defs_kin_deltesian, defs_kin_polar, defs_kin_rotary_delta, defs_kin_winch,
     defs_kin_extruder, defs_kin_shaper, defs_kin_idex,
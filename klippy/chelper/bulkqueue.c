@@ -0,0 +1,146 @@
+// Storage of bulk sensor data messages received from the mcu
+//
+// Copyright (C) 2026  The Klipper developers
+//
+// This file may be distributed under the terms of the GNU GPLv3 license.
+
+#include <pthread.h> // pthread_mutex_lock
+#include <stddef.h> // offsetof
+#include <stdlib.h> // malloc
+#include <string.h> // memset
+#include "compiler.h" // container_of
+#include "msgblock.h" // msgblock_parse_vlq
+#include "pyhelper.h" // errorf
+#include "serialqueue.h" // serialqueue_add_fastreader
+
+// Sensors can report thousands of measurements a second.  Rather
+// than passing each "sensor_bulk_data" message through the generic
+// python message parser, the serialqueue background thread decodes
+// them here and stores the raw data in a ring buffer.  The host code
+// then periodically copies out a batch of entries in a single call.
+
+struct pull_bulk_data {
+    uint32_t sequence, len;
+    uint8_t data[MESSAGE_PAYLOAD_MAX];
+};
+
+struct bulkqueue {
+    struct fastreader fr;
+    struct serialqueue *sq;
+
+    pthread_mutex_t lock; // protects variables below
+    struct pull_bulk_data *entries;
+    uint32_t size, pos, count;
+};
+
+#define BULKQUEUE_INITIAL_SIZE 256
+
+// Double the size of the ring buffer (caller must hold lock)
+static int
+grow_entries(struct bulkqueue *bq)
+{
+    uint32_t new_size = bq->size ? bq->size * 2 : BULKQUEUE_INITIAL_SIZE;
+    struct pull_bulk_data *ne = malloc(new_size * sizeof(*ne));
+    if (!ne)
+        return -1;
+    uint32_t i;
+    for (i=0; i<bq->count; i++)
+        ne[i] = bq->entries[(bq->pos + i) & (bq->size - 1)];
+    free(bq->entries);
+    bq->entries = ne;
+    bq->size = new_size;
+    bq->pos = 0;
+    return 0;
+}
+
+// Handle a sensor_bulk_data message (callback from serialqueue fastreader)
+static void
+handle_bulk_data(struct fastreader *fr, double eventtime
+                 , uint8_t *data, int len)
+{
+    struct bulkqueue *bq = container_of(fr, struct bulkqueue, fr);
+
+    // Parse: sensor_bulk_data oid=%c sequence=%hu data=%*s
+    uint8_t *p = &data[MESSAGE_HEADER_SIZE + fr->prefix_len];
+    uint8_t *end = &data[len - MESSAGE_TRAILER_SIZE];
+    uint32_t sequence, data_len;
+    int ret = msgblock_parse_vlq(&sequence, &p, end);
+    if (!ret)
+        ret = msgblock_parse_vlq(&data_len, &p, end);
+    if (ret || data_len != end - p)
+        return;
+
+    // Store in ring buffer
+    pthread_mutex_lock(&bq->lock);
+    if (bq->count >= bq->size && grow_entries(bq)) {
+        errorf("bulkqueue: unable to allocate memory");
+        pthread_mutex_unlock(&bq->lock);
+        return;
+    }
+    struct pull_bulk_data *e = &bq->entries[
+        (bq->pos + bq->count) & (bq->size - 1)];
+    e->sequence = sequence;
+    e->len = data_len;
+    memcpy(e->data, p, data_len);
+    bq->count++;
+    pthread_mutex_unlock(&bq->lock);
+}
+
+// Create a new 'struct bulkqueue' object
+struct bulkqueue * __visible
+bulkqueue_alloc(void)
+{
+    struct bulkqueue *bq = malloc(sizeof(*bq));
+    memset(bq, 0, sizeof(*bq));
+    int ret = pthread_mutex_init(&bq->lock, NULL);
+    if (ret) {
+        report_errno("bulkqueue_alloc pthread_mutex_init", ret);
+        free(bq);
+        return NULL;
+    }
+    return bq;
+}
+
+// Start capturing messages with the given msgtag and oid
+void __visible
+bulkqueue_setup(struct bulkqueue *bq, struct serialqueue *sq
+                , uint32_t msgtag, uint32_t oid)
+{
+    uint32_t prefix[] = {msgtag, oid};
+    struct queue_message *dummy = message_alloc_and_encode(
+        prefix, ARRAY_SIZE(prefix));
+    memcpy(bq->fr.prefix, dummy->msg, dummy->len);
+    bq->fr.prefix_len = dummy->len;
+    message_free(dummy);
+    bq->fr.func = handle_bulk_data;
+    bq->fr.exclusive = 1;
+    bq->sq = sq;
+    serialqueue_add_fastreader(sq, &bq->fr);
+}
+
+// Copy up to 'max' queued messages into 'pbd' (returns count copied)
+int __visible
+bulkqueue_pull(struct bulkqueue *bq, struct pull_bulk_data *pbd, int max)
+{
+    pthread_mutex_lock(&bq->lock);
+    int count = bq->count < max ? bq->count : max, i;
+    for (i=0; i<count; i++)
+        pbd[i] = bq->entries[(bq->pos + i) & (bq->size - 1)];
+    bq->pos = (bq->pos + count) & (bq->size - 1);
+    bq->count -= count;
+    pthread_mutex_unlock(&bq->lock);
+    return count;
+}
+
+// Free memory associated with a 'struct bulkqueue' object.  The
+// serialqueue it was setup with must not be freed before this call.
+void __visible
+bulkqueue_free(struct bulkqueue *bq)
+{
+    if (!bq)
+        return;
+    if (bq->sq)
+        serialqueue_rm_fastreader(bq->sq, &bq->fr);
+    free(bq->entries);
+    free(bq);
+}
@@ -0,0 +1,259 @@
+// Fast tokenizing of simple g-code lines
+//
+// Copyright (C) 2026  The Klipper developers
+//
+// This file may be distributed under the terms of the GNU GPLv3 license.
+
+#include <stdint.h> // uint32_t
+#include <stdlib.h> // strtod
+#include <string.h> // memcpy
+#include "compiler.h" // __visible
+
+// The python gcode dispatcher passes a batch of newline separated
+// lines here.  Lines containing a "traditional" command (a letter
+// followed by an integer) with only single letter numeric parameters
+// are tokenized.  Anything else (line numbers, checksums, extended
+// commands, unusual formatting) is reported with a code of zero so
+// that it can be handled by the regular python parser.
+//
+// The same tokens may also be stored in a pre-parsed g-code file (see
+// scripts/preparse_gcode.py).  Such a file starts with a header and
+// then contains a sequence of little endian records: a uint32 command
+// code followed by either (code 0) a uint16 length and the text of a
+// line, or a uint32 parameter mask and a value for each bit set in the
+// mask (in bit order).  A value is stored as a decimal scale byte and
+// a zigzag encoded varint mantissa (value = mantissa / 10^scale) or
+// as PREPARSED_RAW_DOUBLE followed by the raw double.
+
+#define GCODEPARSE_MAX_CMD_DIGITS 4
+#define PREPARSED_RAW_DOUBLE 0xff
+
+struct gcodeparse_line {
+    uint32_t code, param_mask;
+    double values[26];
+};
+
+static inline int
+is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline int
+to_upper(char c)
+{
+    return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
+}
+
+static inline int
+is_letter(char c)
+{
+    c = to_upper(c);
+    return c >= 'A' && c <= 'Z';
+}
+
+static inline int
+is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Parse a number (of the form accepted by python's float() once the
+// gcode letters have been split out)
+static int
+parse_number(double *res, char *p, char *end)
+{
+    char buf[32], *s = p;
+    int digits = 0;
+    if (s < end && (*s == '-' || *s == '+'))
+        s++;
+    while (s < end && is_digit(*s))
+        s++, digits++;
+    if (s < end && *s == '.') {
+        s++;
+        while (s < end && is_digit(*s))
+            s++, digits++;
+    }
+    if (s != end || !digits || end - p >= sizeof(buf))
+        return -1;
+    memcpy(buf, p, end - p);
+    buf[end - p] = '\0';
+    *res = strtod(buf, NULL);
+    return 0;
+}
+
+// Tokenize a single line (returns the command code or zero)
+static int
+parse_line(struct gcodeparse_line *gl, char *p, char *end)
+{
+    // Strip comments and whitespace
+    char *c = memchr(p, ';', end - p);
+    if (c)
+        end = c;
+    while (p < end && is_space(*p))
+        p++;
+    while (end > p && is_space(end[-1]))
+        end--;
+
+    // Parse command (letter followed by an integer without leading zeros)
+    if (p >= end || !is_letter(*p))
+        return 0;
+    int letter = to_upper(*p++);
+    if (letter == 'N' || p >= end || !is_digit(*p))
+        return 0;
+    uint32_t num = 0;
+    char *num_start = p;
+    while (p < end && is_digit(*p))
+        num = num * 10 + *p++ - '0';
+    if ((*num_start == '0' && p - num_start > 1)
+        || p - num_start > GCODEPARSE_MAX_CMD_DIGITS)
+        return 0;
+    if (p < end && !is_space(*p) && !is_letter(*p))
+        return 0;
+
+    // Parse parameters
+    uint32_t mask = 0;
+    while (p < end) {
+        while (p < end && is_space(*p))
+            p++;
+        if (p >= end)
+            break;
+        if (!is_letter(*p))
+            return 0;
+        int idx = to_upper(*p++) - 'A';
+        char *v = p;
+        while (p < end && !is_letter(*p))
+            p++;
+        char *vend = p;
+        while (vend > v && is_space(vend[-1]))
+            vend--;
+        while (v < vend && is_space(*v))
+            v++;
+        if (parse_number(&gl->values[idx], v, vend))
+            return 0;
+        mask |= 1 << idx;
+    }
+    gl->param_mask = mask;
+    return (letter << 16) | num;
+}
+
+// Tokenize up to 'max' newline separated lines from 'buf' (returns
+// the number of lines processed)
+int __visible
+gcodeparse_lines(char *buf, int len, struct gcodeparse_line *lines, int max)
+{
+    char *p = buf, *end = &buf[len];
+    int count = 0;
+    while (count < max) {
+        char *eol = memchr(p, '\n', end - p);
+        if (!eol)
+            eol = end;
+        struct gcodeparse_line *gl = &lines[count++];
+        gl->param_mask = 0;
+        gl->code = parse_line(gl, p, eol);
+        if (eol >= end)
+            break;
+        p = eol + 1;
+    }
+    return count;
+}
+
+static uint32_t
+read_u32(uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static const double pow10_table[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Decode a parameter value (returns the number of bytes used, zero if
+// more data is needed, or -1 if the data is invalid)
+static int
+decode_value(double *res, uint8_t *p, uint8_t *end)
+{
+    if (p >= end)
+        return 0;
+    uint8_t scale = *p;
+    if (scale == PREPARSED_RAW_DOUBLE) {
+        if (end - p < 1 + sizeof(*res))
+            return 0;
+        memcpy(res, &p[1], sizeof(*res));
+        return 1 + sizeof(*res);
+    }
+    if (scale >= ARRAY_SIZE(pow10_table))
+        return -1;
+    uint64_t v = 0;
+    int i;
+    for (i=1; ; i++) {
+        if (i > 8)
+            return -1;
+        if (&p[i] >= end)
+            return 0;
+        uint8_t c = p[i];
+        v |= (uint64_t)(c & 0x7f) << ((i - 1) * 7);
+        if (!(c & 0x80))
+            break;
+    }
+    int64_t mantissa = (v >> 1) ^ -(int64_t)(v & 1);
+    *res = (double)mantissa / pow10_table[scale];
+    return i + 1;
+}
+
+// Decode up to 'max' records of a pre-parsed g-code file.  The offset
+// of each record is stored in 'offsets' (along with the offset after
+// the last record).  Returns the number of complete records decoded
+// or -1 if the data is invalid.
+int __visible
+gcodeparse_decode(uint8_t *buf, int len, struct gcodeparse_line *lines
+                  , int max, int *offsets)
+{
+    uint8_t *p = buf, *end = &buf[len];
+    int count = 0;
+    while (count < max && end - p >= 6) {
+        struct gcodeparse_line *gl = &lines[count];
+        uint8_t *rec = p;
+        uint32_t code = read_u32(p);
+        if (!code) {
+            // Text record
+            int text_len = p[4] | (p[5] << 8);
+            if (end - p < 6 + text_len)
+                break;
+            p += 6 + text_len;
+            gl->param_mask = 0;
+        } else {
+            // Tokenized command record
+            uint32_t letter = code >> 16;
+            if (letter < 'A' || letter > 'Z')
+                return -1;
+            if (end - p < 8)
+                break;
+            uint32_t mask = read_u32(&p[4]);
+            if (mask >> 26)
+                return -1;
+            p += 8;
+            int i, ret = 1;
+            for (i=0; i<26; i++) {
+                if (!(mask & (1 << i)))
+                    continue;
+                ret = decode_value(&gl->values[i], p, end);
+                if (ret <= 0)
+                    break;
+                p += ret;
+            }
+            if (ret < 0)
+                return -1;
+            if (!ret) {
+                p = rec;
+                break;
+            }
+            gl->param_mask = mask;
+        }
+        gl->code = code;
+        offsets[count++] = rec - buf;
+    }
+    offsets[count] = p - buf;
+    return count;
+}
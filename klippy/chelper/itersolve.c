@@ -24,11 +24,17 @@ struct timepos {
 
 #define SEEK_TIME_RESET 0.000100
 
+static int32_t itersolve_gen_steps_linear(
+    struct stepper_kinematics *sk, struct stepcompress *sc, struct move *m
+    , double abs_start, double abs_end);
+
 // Generate step times for a portion of a move
 static int32_t
 itersolve_gen_steps_range(struct stepper_kinematics *sk, struct stepcompress *sc
                           , struct move *m, double abs_start, double abs_end)
 {
+    if (sk->is_linear)
+        return itersolve_gen_steps_linear(sk, sc, m, abs_start, abs_end);
     sk_calc_callback calc_position_cb = sk->calc_position_cb;
     double half_step = .5 * sk->step_dist;
     double start = abs_start - m->print_time, end = abs_end - m->print_time;
@@ -128,6 +134,96 @@ itersolve_gen_steps_range(struct stepper_kinematics *sk, struct stepcompress *sc
 }
 
 
+
+/****************************************************************
+ * Closed form solver for linear kinematics
+ ****************************************************************/
+
+// On kinematics where the stepper position is a linear combination of
+// the cartesian axes, the stepper position during a move has the form
+// "pos0 + v0*t + half_accel_r*t^2".  The time of each step can then be
+// found directly from the quadratic formula.
+
+// Return the time (relative to 'start') that a quadratic reaches 'dist'
+static inline double
+solve_step_time(double v0, double half_accel_r, double dist, int sdir)
+{
+    double disc = v0*v0 + 4. * half_accel_r * dist;
+    if (disc < 0.)
+        disc = 0.;
+    // Numerically stable form of the quadratic formula
+    double div = sdir ? v0 + sqrt(disc) : v0 - sqrt(disc);
+    if (!div)
+        return 0.;
+    return 2. * dist / div;
+}
+
+// Generate step times for a portion of a move on a linear stepper
+static int32_t
+itersolve_gen_steps_linear(struct stepper_kinematics *sk, struct stepcompress *sc
+                           , struct move *m, double abs_start, double abs_end)
+{
+    double *lc = sk->linear_coeffs;
+    double base = (lc[0] * m->start_pos.x + lc[1] * m->start_pos.y
+                   + lc[2] * m->start_pos.z);
+    double ratio = (lc[0] * m->axes_r.x + lc[1] * m->axes_r.y
+                    + lc[2] * m->axes_r.z);
+    double v0 = ratio * m->start_v, half_accel_r = ratio * m->half_accel;
+    double start = abs_start - m->print_time, end = abs_end - m->print_time;
+    if (start < 0.)
+        start = 0.;
+    if (end > m->move_t)
+        end = m->move_t;
+    // Split the range at the point of velocity reversal (if any)
+    double seg_end[2] = { end, end };
+    if (half_accel_r) {
+        double rev_time = -v0 / (2. * half_accel_r);
+        if (rev_time > start && rev_time < end)
+            seg_end[0] = rev_time;
+    }
+    double half_step = .5 * sk->step_dist, pos = sk->commanded_pos;
+    int sdir = stepcompress_get_step_dir(sc), i;
+    double seg_start = start;
+    for (i=0; i<2 && seg_start < end; i++) {
+        // Find all steps in this monotonic portion of the move
+        double t0 = seg_start, t1 = seg_end[i];
+        double p0 = base + ratio * move_get_distance(m, t0);
+        double p1 = base + ratio * move_get_distance(m, t1);
+        double seg_v0 = v0 + 2. * half_accel_r * t0;
+        int seg_dir = p1 > p0;
+        for (;;) {
+            double target = seg_dir ? pos + half_step : pos - half_step;
+            if (seg_dir ? p1 < target : p1 > target)
+                break;
+            double step_time = t0 + solve_step_time(
+                seg_v0, half_accel_r, target - p0, seg_dir);
+            if (!(step_time >= t0)) // or NaN
+                step_time = t0;
+            if (step_time > t1)
+                step_time = t1;
+            int ret = stepcompress_append(sc, seg_dir, m->print_time
+                                          , step_time);
+            if (ret)
+                return ret;
+            pos = seg_dir ? target + half_step : target - half_step;
+            sdir = seg_dir;
+        }
+        // Avoid rollback if stepper fully reaches step position
+        double reach = (sdir ? (p0 > p1 ? p0 : p1) : (p0 < p1 ? p0 : p1));
+        if (sdir ? reach >= pos : reach <= pos) {
+            int ret = stepcompress_commit(sc);
+            if (ret)
+                return ret;
+        }
+        seg_start = t1;
+    }
+    sk->commanded_pos = pos;
+    if (sk->post_cb)
+        sk->post_cb(sk);
+    return 0;
+}
+
+
 /****************************************************************
  * Interface functions
  ****************************************************************/
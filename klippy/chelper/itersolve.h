@@ -23,6 +23,11 @@ struct stepper_kinematics {
 
     sk_calc_callback calc_position_cb;
     sk_post_callback post_cb;
+
+    // Optional - stepper position is a linear combination of the x, y,
+    // and z toolhead positions (enables a closed form step solver)
+    int is_linear;
+    double linear_coeffs[3];
 };
 
 int32_t itersolve_generate_steps(struct stepper_kinematics *sk
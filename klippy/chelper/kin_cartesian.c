@@ -47,5 +47,9 @@ cartesian_stepper_alloc(char axis)
         sk->calc_position_cb = cart_stepper_z_calc_position;
         sk->active_flags = AF_Z;
     }
+    if (axis >= 'x' && axis <= 'z') {
+        sk->is_linear = 1;
+        sk->linear_coeffs[axis - 'x'] = 1.;
+    }
     return sk;
 }
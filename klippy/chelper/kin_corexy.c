@@ -36,5 +36,8 @@ corexy_stepper_alloc(char type)
     else if (type == '-')
         sk->calc_position_cb = corexy_stepper_minus_calc_position;
     sk->active_flags = AF_X | AF_Y;
+    sk->is_linear = 1;
+    sk->linear_coeffs[0] = 1.;
+    sk->linear_coeffs[1] = type == '+' ? 1. : -1.;
     return sk;
 }
@@ -35,6 +35,10 @@ generic_cartesian_stepper_set_coeffs(struct stepper_kinematics *sk
     cs->a.x = a_x;
     cs->a.y = a_y;
     cs->a.z = a_z;
+    cs->sk.is_linear = 1;
+    cs->sk.linear_coeffs[0] = a_x;
+    cs->sk.linear_coeffs[1] = a_y;
+    cs->sk.linear_coeffs[2] = a_z;
     cs->sk.active_flags = 0;
     if (a_x) cs->sk.active_flags |= AF_X;
     if (a_y) cs->sk.active_flags |= AF_Y;
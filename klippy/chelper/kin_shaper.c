@@ -21,10 +21,16 @@
 static const int KIN_FLAGS[3] = { AF_X, AF_Y, AF_Z };
 
 struct shaper_pulses {
-    int num_pulses, p_ind;
+    int num_pulses;
     struct {
         double t, a;
     } pulses[10];
+    // The move each pulse was last evaluated on, and the start time of
+    // that move relative to the start of the move being evaluated
+    struct {
+        struct move *m;
+        double offset;
+    } cache[10];
 };
 
 // Shift pulses around 'mid-point' t=0 so that the input shaper is an identity
@@ -38,10 +44,6 @@ shift_pulses(struct shaper_pulses *sp)
         ts += sp->pulses[i].a * sp->pulses[i].t;
     for (i = 0; i < sp->num_pulses; ++i)
         sp->pulses[i].t -= ts;
-    // Find the first pulse with positive time
-    for (i = 0; i < sp->num_pulses; ++i)
-        if (sp->pulses[i].t > 0) break;
-    sp->p_ind = i;
 }
 
 static int
@@ -91,30 +93,39 @@ calc_position(struct move *m, int axis, double move_time
 {
     double res = 0.;
     int num_pulses = sp->num_pulses, i;
-    struct move *prev = m;
-    double t = move_time;
-    for (i = sp->p_ind - 1; i >= 0; --i) {
-        t += sp->pulses[i].t;
-        while (likely(t < 0.)) {
-            prev = list_prev_entry(prev, node);
-            t += prev->move_t;
+    for (i = 0; i < num_pulses; ++i) {
+        // Start the search from the move this pulse was last evaluated on
+        struct move *pm = sp->cache[i].m;
+        double offset = sp->cache[i].offset;
+        double t = move_time + sp->pulses[i].t - offset;
+        while (unlikely(t < 0.)) {
+            pm = list_prev_entry(pm, node);
+            t += pm->move_t;
+            offset -= pm->move_t;
         }
-        res += sp->pulses[i].a * get_axis_position(prev, axis, t);
-        t -= sp->pulses[i].t;
-    }
-    t = move_time;
-    for (i = sp->p_ind; i < num_pulses; ++i) {
-        t += sp->pulses[i].t;
-        while (likely(t > m->move_t)) {
-            t -= m->move_t;
-            m = list_next_entry(m, node);
+        while (unlikely(t > pm->move_t)) {
+            t -= pm->move_t;
+            offset += pm->move_t;
+            pm = list_next_entry(pm, node);
         }
-        res += sp->pulses[i].a * get_axis_position(m, axis, t);
-        t -= sp->pulses[i].t;
+        sp->cache[i].m = pm;
+        sp->cache[i].offset = offset;
+        res += sp->pulses[i].a * get_axis_position(pm, axis, t);
     }
     return res;
 }
 
+// Reset the per-pulse move cache of a shaper to the given move
+static void
+reset_pulse_cache(struct shaper_pulses *sp, struct move *m)
+{
+    int i;
+    for (i = 0; i < sp->num_pulses; ++i) {
+        sp->cache[i].m = m;
+        sp->cache[i].offset = 0.;
+    }
+}
+
 
 /****************************************************************
  * Kinematics-related shaper code
@@ -127,8 +138,27 @@ struct input_shaper {
     struct stepper_kinematics *orig_sk;
     struct move m;
     struct shaper_pulses sp[3];
+    struct move *cache_m;
+    double cache_flush_time;
 };
 
+// Check that the per-pulse move caches are valid for the given move.
+// Moves may be freed between calls to itersolve_generate_steps(), so
+// the caches are only reused while evaluating the same move within a
+// single step generation pass.
+static inline void
+check_pulse_cache(struct input_shaper *is, struct move *m)
+{
+    if (likely(m == is->cache_m
+               && is->sk.last_flush_time == is->cache_flush_time))
+        return;
+    is->cache_m = m;
+    is->cache_flush_time = is->sk.last_flush_time;
+    int i;
+    for (i = 0; i < ARRAY_SIZE(is->sp); ++i)
+        reset_pulse_cache(&is->sp[i], m);
+}
+
 // Optimized calc_position when only x axis is needed
 static double
 shaper_x_calc_position(struct stepper_kinematics *sk, struct move *m
@@ -138,6 +168,7 @@ shaper_x_calc_position(struct stepper_kinematics *sk, struct move *m
     struct shaper_pulses *sx = &is->sp[0];
     if (!sx->num_pulses)
         return is->orig_sk->calc_position_cb(is->orig_sk, m, move_time);
+    check_pulse_cache(is, m);
     is->m.start_pos.x = calc_position(m, 'x', move_time, sx);
     return is->orig_sk->calc_position_cb(is->orig_sk, &is->m, DUMMY_T);
 }
@@ -151,6 +182,7 @@ shaper_y_calc_position(struct stepper_kinematics *sk, struct move *m
     struct shaper_pulses *sy = &is->sp[1];
     if (!sy->num_pulses)
         return is->orig_sk->calc_position_cb(is->orig_sk, m, move_time);
+    check_pulse_cache(is, m);
     is->m.start_pos.y = calc_position(m, 'y', move_time, sy);
     return is->orig_sk->calc_position_cb(is->orig_sk, &is->m, DUMMY_T);
 }
@@ -164,6 +196,7 @@ shaper_z_calc_position(struct stepper_kinematics *sk, struct move *m
     struct shaper_pulses *sz = &is->sp[2];
     if (!sz->num_pulses)
         return is->orig_sk->calc_position_cb(is->orig_sk, m, move_time);
+    check_pulse_cache(is, m);
     is->m.start_pos.z = calc_position(m, 'z', move_time, sz);
     return is->orig_sk->calc_position_cb(is->orig_sk, &is->m, DUMMY_T);
 }
@@ -176,6 +209,7 @@ shaper_xyz_calc_position(struct stepper_kinematics *sk, struct move *m
     struct input_shaper *is = container_of(sk, struct input_shaper, sk);
     if (!is->sp[0].num_pulses && !is->sp[1].num_pulses && !is->sp[2].num_pulses)
         return is->orig_sk->calc_position_cb(is->orig_sk, m, move_time);
+    check_pulse_cache(is, m);
     is->m.start_pos = move_get_coord(m, move_time);
     if (is->sp[0].num_pulses)
         is->m.start_pos.x = calc_position(m, 'x', move_time, &is->sp[0]);
@@ -279,6 +313,7 @@ input_shaper_set_shaper_params(struct stepper_kinematics *sk, char axis
     // Ignore input shaper update if the axis is not active
     if (is->orig_sk->active_flags & KIN_FLAGS[axis_ind]) {
         status = init_shaper(n, a, t, sp);
+        is->cache_m = NULL;
         shaper_note_generation_time(is);
     }
     return status;
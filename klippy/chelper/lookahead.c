@@ -0,0 +1,315 @@
+// Toolhead "look-ahead" junction velocity planning
+//
+// Copyright (C) 2016-2025  Kevin O'Connor <kevin@koconnor.net>
+// Copyright (C) 2026  The Klipper developers
+//
+// This file may be distributed under the terms of the GNU GPLv3 license.
+
+#include <math.h> // sqrt
+#include <stdlib.h> // malloc
+#include <string.h> // memcpy
+#include "compiler.h" // __visible
+#include "pyhelper.h" // errorf
+
+// The python toolhead code creates a "Move" object for each requested
+// move and checks it against the kinematic and extra axis limits.  The
+// parameters needed to plan the move's junction speeds are then queued
+// here and the junction calculations are done in C (see toolhead.py
+// for a description of them).  Junction speeds are tracked in velocity
+// squared.  Queued moves are stored as a "struct of arrays" - one array
+// of doubles per field, indexed by the move's position in the queue.
+
+enum {
+    // Move parameters
+    LA_IS_KINEMATIC, LA_MOVE_D, LA_AXES_R_X, LA_AXES_R_Y, LA_AXES_R_Z,
+    LA_ACCEL, LA_JUNCTION_DEVIATION, LA_MAX_CRUISE_V2, LA_DELTA_V2,
+    LA_MCR_DELTA_V2, LA_NEXT_JUNCTION_V2,
+    // Junction limits (calculated when the move is queued)
+    LA_MAX_START_V2, LA_MAX_MCR_START_V2,
+    // Temporary storage used during a flush
+    LA_START_V2, LA_CRUISE_V2, LA_NEXT_START_V2,
+    LA_FIELD_COUNT
+};
+
+struct lookahead {
+    double *fields[LA_FIELD_COUNT];
+    int move_count, alloc_count;
+};
+
+struct lookahead_result {
+    double start_v, cruise_v, end_v;
+    double accel_t, cruise_t, decel_t;
+};
+
+#define LOOKAHEAD_INITIAL_ALLOC 64
+#define NO_JUNCTION_LIMIT 999999999.9
+// Marker for a cruise_v2 that must be propagated from the prior move
+#define CRUISE_V2_UNSET -1.
+
+
+/****************************************************************
+ * Move queue storage
+ ****************************************************************/
+
+// Allocate a new 'lookahead' object
+struct lookahead * __visible
+lookahead_alloc(void)
+{
+    struct lookahead *la = malloc(sizeof(*la));
+    memset(la, 0, sizeof(*la));
+    return la;
+}
+
+// Free memory associated with a 'lookahead' object
+void __visible
+lookahead_free(struct lookahead *la)
+{
+    if (!la)
+        return;
+    free(la->fields[0]);
+    free(la);
+}
+
+// Discard all queued moves
+void __visible
+lookahead_reset(struct lookahead *la)
+{
+    la->move_count = 0;
+}
+
+// Make room for more moves (all fields share one allocation)
+static int
+lookahead_grow(struct lookahead *la)
+{
+    int alloc = la->alloc_count ? la->alloc_count * 2
+                                : LOOKAHEAD_INITIAL_ALLOC;
+    double *data = malloc(sizeof(*data) * alloc * LA_FIELD_COUNT);
+    if (!data) {
+        errorf("lookahead_grow: out of memory");
+        return -1;
+    }
+    double *old_data = la->fields[0];
+    int i;
+    for (i=0; i<LA_FIELD_COUNT; i++) {
+        double *nf = &data[i * alloc];
+        if (la->move_count)
+            memcpy(nf, la->fields[i], sizeof(*nf) * la->move_count);
+        la->fields[i] = nf;
+    }
+    free(old_data);
+    la->alloc_count = alloc;
+    return 0;
+}
+
+// Remove the first 'count' moves from the queue
+static void
+lookahead_discard(struct lookahead *la, int count)
+{
+    int remaining = la->move_count - count, i;
+    if (remaining)
+        for (i=0; i<LA_FIELD_COUNT; i++)
+            memmove(la->fields[i], &la->fields[i][count]
+                    , sizeof(double) * remaining);
+    la->move_count = remaining;
+}
+
+
+/****************************************************************
+ * Junction calculations
+ ****************************************************************/
+
+// The min() and max() helpers have the same semantics as the python
+// builtins so that results are identical to the python planner
+static inline double
+min2(double a, double b)
+{
+    return b < a ? b : a;
+}
+
+static inline double
+max2(double a, double b)
+{
+    return b > a ? b : a;
+}
+
+// Determine the maximum start velocity of move 'i' given the move
+// that precedes it
+static void
+calc_junction(struct lookahead *la, int i, double extra_v2)
+{
+    double **f = la->fields;
+    int p = i - 1;
+    double max_start_v2 = f[LA_MAX_CRUISE_V2][i];
+    max_start_v2 = min2(max_start_v2, f[LA_MAX_CRUISE_V2][p]);
+    max_start_v2 = min2(max_start_v2, f[LA_NEXT_JUNCTION_V2][p]);
+    max_start_v2 = min2(max_start_v2
+                        , f[LA_MAX_START_V2][p] + f[LA_DELTA_V2][p]);
+    max_start_v2 = min2(max_start_v2, extra_v2);
+    // Find max velocity using "approximated centripetal velocity"
+    double junction_cos_theta = -(f[LA_AXES_R_X][i] * f[LA_AXES_R_X][p]
+                                  + f[LA_AXES_R_Y][i] * f[LA_AXES_R_Y][p]
+                                  + f[LA_AXES_R_Z][i] * f[LA_AXES_R_Z][p]);
+    double sin_theta_d2 = sqrt(max2(0.5*(1.0-junction_cos_theta), 0.));
+    double cos_theta_d2 = sqrt(max2(0.5*(1.0+junction_cos_theta), 0.));
+    double one_minus_sin_theta_d2 = 1. - sin_theta_d2;
+    if (one_minus_sin_theta_d2 > 0. && cos_theta_d2 > 0.) {
+        double R_jd = sin_theta_d2 / one_minus_sin_theta_d2;
+        double move_jd_v2 = (R_jd * f[LA_JUNCTION_DEVIATION][i]
+                             * f[LA_ACCEL][i]);
+        double pmove_jd_v2 = (R_jd * f[LA_JUNCTION_DEVIATION][p]
+                              * f[LA_ACCEL][p]);
+        // Approximated circle must contact moves no further than mid-move
+        double quarter_tan_theta_d2 = .25 * sin_theta_d2 / cos_theta_d2;
+        double move_centripetal_v2 = f[LA_DELTA_V2][i] * quarter_tan_theta_d2;
+        double pmove_centripetal_v2 = (f[LA_DELTA_V2][p]
+                                       * quarter_tan_theta_d2);
+        max_start_v2 = min2(max_start_v2, move_jd_v2);
+        max_start_v2 = min2(max_start_v2, pmove_jd_v2);
+        max_start_v2 = min2(max_start_v2, move_centripetal_v2);
+        max_start_v2 = min2(max_start_v2, pmove_centripetal_v2);
+    }
+    // Apply limits
+    f[LA_MAX_START_V2][i] = max_start_v2;
+    f[LA_MAX_MCR_START_V2][i] = min2(
+        max_start_v2, f[LA_MAX_MCR_START_V2][p] + f[LA_MCR_DELTA_V2][p]);
+}
+
+// Queue a move.  The 'extra_v2' parameter is the maximum junction
+// speed (in velocity squared) permitted by any extra axes (it is only
+// used if this move and the previous move are both kinematic moves).
+int __visible
+lookahead_add_move(struct lookahead *la, int is_kinematic, double move_d
+                   , double axes_r_x, double axes_r_y, double axes_r_z
+                   , double accel, double junction_deviation
+                   , double max_cruise_v2, double delta_v2
+                   , double mcr_delta_v2, double extra_v2)
+{
+    if (la->move_count >= la->alloc_count && lookahead_grow(la))
+        return -1;
+    double **f = la->fields;
+    int i = la->move_count++;
+    f[LA_IS_KINEMATIC][i] = is_kinematic;
+    f[LA_MOVE_D][i] = move_d;
+    f[LA_AXES_R_X][i] = axes_r_x;
+    f[LA_AXES_R_Y][i] = axes_r_y;
+    f[LA_AXES_R_Z][i] = axes_r_z;
+    f[LA_ACCEL][i] = accel;
+    f[LA_JUNCTION_DEVIATION][i] = junction_deviation;
+    f[LA_MAX_CRUISE_V2][i] = max_cruise_v2;
+    f[LA_DELTA_V2][i] = delta_v2;
+    f[LA_MCR_DELTA_V2][i] = mcr_delta_v2;
+    f[LA_NEXT_JUNCTION_V2][i] = NO_JUNCTION_LIMIT;
+    f[LA_MAX_START_V2][i] = f[LA_MAX_MCR_START_V2][i] = 0.;
+    if (i && is_kinematic && f[LA_IS_KINEMATIC][i-1])
+        calc_junction(la, i, extra_v2);
+    return 0;
+}
+
+// Limit the speed at the junction following the last queued move
+void __visible
+lookahead_limit_next_junction(struct lookahead *la, double v2)
+{
+    if (!la->move_count)
+        return;
+    double *next_junction_v2 = la->fields[LA_NEXT_JUNCTION_V2];
+    int last = la->move_count - 1;
+    next_junction_v2[last] = min2(next_junction_v2[last], v2);
+}
+
+
+/****************************************************************
+ * Flushing
+ ****************************************************************/
+
+// Determine the velocities and timing of the accel, cruise, and
+// decel portions of a move
+static void
+set_junction(struct lookahead_result *r, double move_d, double accel
+             , double start_v2, double cruise_v2, double end_v2)
+{
+    // Determine accel, cruise, and decel portions of the move distance
+    double half_inv_accel = .5 / accel;
+    double accel_d = (cruise_v2 - start_v2) * half_inv_accel;
+    double decel_d = (cruise_v2 - end_v2) * half_inv_accel;
+    double cruise_d = move_d - accel_d - decel_d;
+    // Determine move velocities
+    double start_v = r->start_v = sqrt(start_v2);
+    double cruise_v = r->cruise_v = sqrt(cruise_v2);
+    double end_v = r->end_v = sqrt(end_v2);
+    // Determine time spent in each portion of move (time is the
+    // distance divided by average velocity)
+    r->accel_t = accel_d / ((start_v + cruise_v) * 0.5);
+    r->cruise_t = cruise_d / cruise_v;
+    r->decel_t = decel_d / ((end_v + cruise_v) * 0.5);
+}
+
+// Plan the queued moves and remove the moves that are ready to be
+// sent from the queue.  The velocities and timing of the removed moves
+// are stored in 'results' (which must have space for all queued
+// moves).  If 'lazy' is set then only moves that can no longer be
+// altered by future moves are removed.  Returns the number of moves
+// removed.
+int __visible
+lookahead_flush(struct lookahead *la, int lazy
+                , struct lookahead_result *results)
+{
+    double **f = la->fields;
+    double *start_v2s = f[LA_START_V2], *cruise_v2s = f[LA_CRUISE_V2];
+    double *next_start_v2s = f[LA_NEXT_START_V2];
+    int update_flush_count = lazy, flush_count = la->move_count, i;
+    // Traverse queue from last to first move and determine maximum
+    // junction speed assuming the robot comes to a complete stop
+    // after the last move.
+    double next_start_v2 = 0., next_mcr_start_v2 = 0., peak_cruise_v2 = 0.;
+    int pending_cv2_assign = 0;
+    for (i=la->move_count-1; i>=0; i--) {
+        double delta_v2 = f[LA_DELTA_V2][i];
+        double mcr_delta_v2 = f[LA_MCR_DELTA_V2][i];
+        double reachable_start_v2 = next_start_v2 + delta_v2;
+        double start_v2 = min2(f[LA_MAX_START_V2][i], reachable_start_v2);
+        double cruise_v2 = CRUISE_V2_UNSET;
+        pending_cv2_assign++;
+        double reach_mcr_start_v2 = next_mcr_start_v2 + mcr_delta_v2;
+        double mcr_start_v2 = min2(f[LA_MAX_MCR_START_V2][i]
+                                   , reach_mcr_start_v2);
+        if (mcr_start_v2 < reach_mcr_start_v2) {
+            // It's possible for this move to accelerate
+            if (mcr_start_v2 + mcr_delta_v2 > next_mcr_start_v2
+                || pending_cv2_assign > 1) {
+                // This move can both accel and decel, or this is a
+                // full accel move followed by a full decel move
+                if (update_flush_count && peak_cruise_v2) {
+                    flush_count = i + pending_cv2_assign;
+                    update_flush_count = 0;
+                }
+                peak_cruise_v2 = (mcr_start_v2 + reach_mcr_start_v2) * .5;
+            }
+            cruise_v2 = min2((start_v2 + reachable_start_v2) * .5
+                             , f[LA_MAX_CRUISE_V2][i]);
+            cruise_v2 = min2(cruise_v2, peak_cruise_v2);
+            pending_cv2_assign = 0;
+        }
+        start_v2s[i] = start_v2;
+        cruise_v2s[i] = cruise_v2;
+        next_start_v2s[i] = next_start_v2;
+        next_start_v2 = start_v2;
+        next_mcr_start_v2 = mcr_start_v2;
+    }
+    if (update_flush_count || !flush_count)
+        return 0;
+    // Traverse queue in forward direction to propagate cruise_v2
+    double prev_cruise_v2 = 0.;
+    for (i=0; i<flush_count; i++) {
+        double start_v2 = start_v2s[i], cruise_v2 = cruise_v2s[i];
+        if (cruise_v2 == CRUISE_V2_UNSET)
+            // This move can't accelerate - propagate cruise_v2 from previous
+            cruise_v2 = min2(prev_cruise_v2, start_v2);
+        set_junction(&results[i], f[LA_MOVE_D][i], f[LA_ACCEL][i]
+                     , min2(start_v2, cruise_v2), cruise_v2
+                     , min2(next_start_v2s[i], cruise_v2));
+        prev_cruise_v2 = cruise_v2;
+    }
+    // Remove processed moves from the queue
+    lookahead_discard(la, flush_count);
+    return flush_count;
+}
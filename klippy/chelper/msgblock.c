@@ -4,9 +4,11 @@
 //
 // This file may be distributed under the terms of the GNU GPLv3 license.
 
+#include <pthread.h> // pthread_mutex_lock
 #include <stddef.h> // offsetof
 #include <stdlib.h> // malloc
 #include <string.h> // memset
+#include "compiler.h" // __visible
 #include "msgblock.h" // message_alloc
 #include "pyhelper.h" // errorf
 
@@ -86,19 +88,26 @@ f4: *p++ = v & 0x7f;
 }
 
 // Parse an integer that was encoded as a "variable length quantity"
-static uint32_t
-parse_int(uint8_t **pp)
+// (checking that it ends before 'end')
+int
+msgblock_parse_vlq(uint32_t *res, uint8_t **pp, uint8_t *end)
 {
-    uint8_t *p = *pp, c = *p++;
+    uint8_t *p = *pp;
+    if (p >= end)
+        return -1;
+    uint8_t c = *p++;
     uint32_t v = c & 0x7f;
     if ((c & 0x60) == 0x60)
         v |= -0x20;
     while (c & 0x80) {
+        if (p >= end)
+            return -1;
         c = *p++;
         v = (v<<7) | (c & 0x7f);
     }
     *pp = p;
-    return v;
+    *res = v;
+    return 0;
 }
 
 // Parse the VLQ contents of a message
@@ -107,11 +116,9 @@ msgblock_decode(uint32_t *data, int data_len, uint8_t *msg, int msg_len)
 {
     uint8_t *p = &msg[MESSAGE_HEADER_SIZE];
     uint8_t *end = &msg[msg_len - MESSAGE_TRAILER_SIZE];
-    while (data_len--) {
-        if (p >= end)
+    while (data_len--)
+        if (msgblock_parse_vlq(data++, &p, end))
             return -1;
-        *data++ = parse_int(&p);
-    }
     if (p != end)
         // Invalid message
         return -1;
@@ -123,11 +130,127 @@ msgblock_decode(uint32_t *data, int data_len, uint8_t *msg, int msg_len)
  * Command queues
  ****************************************************************/
 
+// Messages are commonly allocated in one thread (eg, a step
+// generation thread) and freed in another (eg, the serialqueue
+// background thread).  To avoid a malloc/free pair for every message,
+// freed messages are stored in a per-thread cache that does not
+// require any locking.  When a cache grows too large a batch of
+// messages is moved to a shared pool, and a thread with an empty
+// cache obtains its messages from that pool.  Only these batch
+// transfers take a lock.
+
+#define MSG_CACHE_BATCH 64
+#define MSG_POOL_MAX_BATCHES 256
+
+// Free messages are chained via their 'node.next' field, and batches
+// in the shared pool are chained via the 'node.prev' field of the
+// first message in each batch.
+struct message_cache {
+    struct list_node *head;
+    int count, registered;
+};
+
+static __thread struct message_cache msg_cache;
+static pthread_mutex_t msg_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct list_node *msg_pool_batches;
+static uint32_t msg_pool_count, msg_alloc_count;
+static pthread_once_t msg_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t msg_key;
+
+// Move messages from the local cache to the shared pool
+static void
+message_pool_put(struct message_cache *mc, int count)
+{
+    struct list_node *first = mc->head, *last = first;
+    int i;
+    for (i=1; i<count; i++)
+        last = last->next;
+    mc->head = last->next;
+    mc->count -= count;
+    last->next = NULL;
+
+    pthread_mutex_lock(&msg_pool_lock);
+    if (count == MSG_CACHE_BATCH
+        && msg_pool_count < MSG_POOL_MAX_BATCHES * MSG_CACHE_BATCH) {
+        first->prev = msg_pool_batches;
+        msg_pool_batches = first;
+        msg_pool_count += count;
+        pthread_mutex_unlock(&msg_pool_lock);
+        return;
+    }
+    pthread_mutex_unlock(&msg_pool_lock);
+
+    // Pool is full (or this is a partial batch) - release the messages
+    while (first) {
+        struct list_node *next = first->next;
+        free(container_of(first, struct queue_message, node));
+        first = next;
+    }
+    __atomic_fetch_sub(&msg_alloc_count, count, __ATOMIC_RELAXED);
+}
+
+// Release the local cache on thread exit
+static void
+message_cache_destroy(void *data)
+{
+    struct message_cache *mc = data;
+    while (mc->count >= MSG_CACHE_BATCH)
+        message_pool_put(mc, MSG_CACHE_BATCH);
+    if (mc->count)
+        message_pool_put(mc, mc->count);
+}
+
+static void
+message_key_init(void)
+{
+    pthread_key_create(&msg_key, message_cache_destroy);
+}
+
+// Register the local cache so that it is released on thread exit
+static void
+message_cache_register(struct message_cache *mc)
+{
+    pthread_once(&msg_key_once, message_key_init);
+    pthread_setspecific(msg_key, mc);
+    mc->registered = 1;
+}
+
+// Refill the local cache from the shared pool (or via malloc)
+static void
+message_cache_fill(struct message_cache *mc)
+{
+    if (!mc->registered)
+        message_cache_register(mc);
+    pthread_mutex_lock(&msg_pool_lock);
+    struct list_node *first = msg_pool_batches;
+    if (first) {
+        msg_pool_batches = first->prev;
+        msg_pool_count -= MSG_CACHE_BATCH;
+    }
+    pthread_mutex_unlock(&msg_pool_lock);
+    if (first) {
+        mc->head = first;
+        mc->count = MSG_CACHE_BATCH;
+        return;
+    }
+    struct queue_message *qm = malloc(sizeof(*qm));
+    qm->node.next = NULL;
+    mc->head = &qm->node;
+    mc->count = 1;
+    __atomic_fetch_add(&msg_alloc_count, 1, __ATOMIC_RELAXED);
+}
+
 // Allocate a 'struct queue_message' object
 struct queue_message *
 message_alloc(void)
 {
-    struct queue_message *qm = malloc(sizeof(*qm));
+    struct message_cache *mc = &msg_cache;
+    if (unlikely(!mc->head))
+        message_cache_fill(mc);
+    struct list_node *n = mc->head;
+    mc->head = n->next;
+    mc->count--;
+    struct queue_message *qm = container_of(n, struct queue_message, node);
     memset(qm, 0, sizeof(*qm));
     return qm;
 }
@@ -167,7 +290,15 @@ fail:
 void
 message_free(struct queue_message *qm)
 {
-    free(qm);
+    struct message_cache *mc = &msg_cache;
+    qm->node.next = mc->head;
+    mc->head = &qm->node;
+    mc->count++;
+    if (unlikely(mc->count >= 2 * MSG_CACHE_BATCH)) {
+        if (!mc->registered)
+            message_cache_register(mc);
+        message_pool_put(mc, MSG_CACHE_BATCH);
+    }
 }
 
 // Free all the messages on a queue
@@ -182,6 +313,16 @@ message_queue_free(struct list_head *root)
     }
 }
 
+// Report the number of messages allocated and held in the shared pool
+void __visible
+message_get_stats(uint32_t *alloc_count, uint32_t *pool_count)
+{
+    *alloc_count = __atomic_load_n(&msg_alloc_count, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&msg_pool_lock);
+    *pool_count = msg_pool_count;
+    pthread_mutex_unlock(&msg_pool_lock);
+}
+
 
 /****************************************************************
  * Clock conversion from 32bit to 64bit
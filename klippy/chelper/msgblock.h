@@ -41,12 +41,14 @@ struct clock_estimate {
 
 uint16_t msgblock_crc16_ccitt(uint8_t *buf, uint8_t len);
 int msgblock_check(uint8_t *need_sync, uint8_t *buf, int buf_len);
+int msgblock_parse_vlq(uint32_t *res, uint8_t **pp, uint8_t *end);
 int msgblock_decode(uint32_t *data, int data_len, uint8_t *msg, int msg_len);
 struct queue_message *message_alloc(void);
 struct queue_message *message_fill(uint8_t *data, int len);
 struct queue_message *message_alloc_and_encode(uint32_t *data, int len);
 void message_free(struct queue_message *qm);
 void message_queue_free(struct list_head *root);
+void message_get_stats(uint32_t *alloc_count, uint32_t *pool_count);
 uint64_t clock_from_clock32(uint64_t last_clock, uint32_t clock32);
 double clock_to_time(struct clock_estimate *ce, uint64_t clock);
 uint64_t clock_from_time(struct clock_estimate *ce, double time);
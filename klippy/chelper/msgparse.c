@@ -0,0 +1,149 @@
+// Fast parsing of messages using the mcu data dictionary
+//
+// Copyright (C) 2026  The Klipper developers
+//
+// This file may be distributed under the terms of the GNU GPLv3 license.
+
+#include <stdlib.h> // malloc
+#include <string.h> // memset
+#include "compiler.h" // __visible
+#include "msgblock.h" // MESSAGE_PAYLOAD_MAX
+
+// The python msgproto code registers the parameter types of each
+// message in the data dictionary.  Each parameter type is a single
+// character: 'u' (unsigned integer), 'i' (signed integer), or 's'
+// (length prefixed buffer).  Buffers are reported as their offset in
+// the message combined with their length (offset | (length << 8)).
+//
+// Only parsing is implemented here.  The high rate host to mcu
+// messages (eg, queue_step and the trsync commands) are already
+// encoded in C via message_alloc_and_encode().  The remaining commands
+// are encoded by msgproto.py at a low rate, and for those the cost of
+// passing the parameters in and the result out of a cffi call is
+// higher than encoding them in python.
+
+struct msgparse_format {
+    uint8_t param_count;
+    char param_types[MESSAGE_PAYLOAD_MAX];
+};
+
+struct msgparse {
+    struct msgparse_format **formats;
+    int first_msgid, format_count;
+};
+
+// Create a new 'struct msgparse' object
+struct msgparse * __visible
+msgparse_alloc(void)
+{
+    struct msgparse *mp = malloc(sizeof(*mp));
+    memset(mp, 0, sizeof(*mp));
+    return mp;
+}
+
+// Free memory associated with a 'struct msgparse' object
+void __visible
+msgparse_free(struct msgparse *mp)
+{
+    if (!mp)
+        return;
+    int i;
+    for (i=0; i<mp->format_count; i++)
+        free(mp->formats[i]);
+    free(mp->formats);
+    free(mp);
+}
+
+// Extend the formats array so that it covers the given message id
+static int
+expand_formats(struct msgparse *mp, int msgid)
+{
+    if (!mp->format_count)
+        mp->first_msgid = msgid;
+    int first = mp->first_msgid, last = first + mp->format_count - 1;
+    int new_first = msgid < first ? msgid : first;
+    int new_last = msgid > last ? msgid : last;
+    int new_count = new_last - new_first + 1;
+    if (new_count == mp->format_count)
+        return 0;
+    struct msgparse_format **nf = malloc(new_count * sizeof(*nf));
+    if (!nf)
+        return -1;
+    memset(nf, 0, new_count * sizeof(*nf));
+    if (mp->format_count)
+        memcpy(&nf[first - new_first], mp->formats
+               , mp->format_count * sizeof(*nf));
+    free(mp->formats);
+    mp->formats = nf;
+    mp->first_msgid = new_first;
+    mp->format_count = new_count;
+    return 0;
+}
+
+// Register the parameter types of a message id
+int __visible
+msgparse_add_format(struct msgparse *mp, int msgid, char *param_types)
+{
+    int count = strlen(param_types);
+    if (count > MESSAGE_PAYLOAD_MAX || expand_formats(mp, msgid))
+        return -1;
+    struct msgparse_format **pmf = &mp->formats[msgid - mp->first_msgid];
+    if (!*pmf) {
+        *pmf = malloc(sizeof(**pmf));
+        if (!*pmf)
+            return -1;
+    }
+    (*pmf)->param_count = count;
+    memcpy((*pmf)->param_types, param_types, count);
+    return 0;
+}
+
+// Parse the message starting at 'pos' in 'msg'.  On success the
+// message id is stored in values[0], the parameters are stored in the
+// remaining slots, and the position after the message is returned.
+// A negative value is returned if the message can not be parsed here.
+int __visible
+msgparse_parse(struct msgparse *mp, uint8_t *msg, int msg_len, int pos
+               , int64_t *values)
+{
+    uint8_t *p = &msg[pos], *end = &msg[msg_len - MESSAGE_TRAILER_SIZE];
+    uint32_t v;
+    if (msgblock_parse_vlq(&v, &p, end))
+        return -1;
+    int32_t msgid = v;
+    uint32_t idx = msgid - mp->first_msgid;
+    if (idx >= mp->format_count)
+        return -1;
+    struct msgparse_format *mf = mp->formats[idx];
+    if (!mf)
+        return -1;
+    *values++ = msgid;
+    int i;
+    for (i=0; i<mf->param_count; i++) {
+        switch (mf->param_types[i]) {
+        case 'u':
+            if (msgblock_parse_vlq(&v, &p, end))
+                return -1;
+            *values++ = v;
+            break;
+        case 'i':
+            if (msgblock_parse_vlq(&v, &p, end))
+                return -1;
+            *values++ = (int32_t)v;
+            break;
+        case 's': {
+            if (p >= end)
+                return -1;
+            uint8_t len = *p++;
+            if (len > end - p)
+                return -1;
+            *values++ = (p - msg) | (len << 8);
+            p += len;
+            break;
+        }
+        default:
+            return -1;
+        }
+    }
+    return p - msg;
+}
@@ -4,11 +4,18 @@
 //
 // This file may be distributed under the terms of the GNU GPLv3 license.
 
+#include <errno.h> // EINTR
 #include <fcntl.h> // fcntl
 #include <math.h> // ceil
 #include <poll.h> // poll
+#include <pthread.h> // pthread_create
+#include <stddef.h> // offsetof
 #include <stdlib.h> // malloc
 #include <string.h> // memset
+#include <sys/epoll.h> // epoll_wait
+#include <unistd.h> // pipe
+#include "compiler.h" // __visible
+#include "list.h" // list_add_tail
 #include "pollreactor.h" // pollreactor_alloc
 #include "pyhelper.h" // report_errno
 
@@ -17,6 +24,11 @@ struct pollreactor_timer {
     double (*callback)(void *data, double eventtime);
 };
 
+struct pollreactor_fdref {
+    struct pollreactor *pr;
+    int pos;
+};
+
 struct pollreactor {
     int num_fds, num_timers, must_exit;
     void *callback_data;
@@ -24,8 +36,18 @@ struct pollreactor {
     struct pollfd *fds;
     void (**fd_callbacks)(void *data, double eventtime);
     struct pollreactor_timer *timers;
+    // Shared thread support
+    struct pollreactor_thread *prt;
+    void (*exit_callback)(void *data);
+    struct pollreactor_fdref *fd_refs;
+    struct list_node prt_node;
+    int prt_state, heap_pos;
 };
 
+enum { PRS_PENDING, PRS_ACTIVE, PRS_DONE };
+
+static void prt_timer_update(struct pollreactor *pr);
+
 // Allocate a new 'struct pollreactor' object
 struct pollreactor *
 pollreactor_alloc(int num_fds, int num_timers, void *callback_data)
@@ -46,6 +68,7 @@ pollreactor_alloc(int num_fds, int num_timers, void *callback_data)
     int i;
     for (i=0; i<num_timers; i++)
         pr->timers[i].waketime = PR_NEVER;
+    pr->heap_pos = -1;
     return pr;
 }
 
@@ -59,6 +82,8 @@ pollreactor_free(struct pollreactor *pr)
     pr->fd_callbacks = NULL;
     free(pr->timers);
     pr->timers = NULL;
+    free(pr->fd_refs);
+    pr->fd_refs = NULL;
     free(pr);
 }
 
@@ -93,8 +118,29 @@ void
 pollreactor_update_timer(struct pollreactor *pr, int pos, double waketime)
 {
     pr->timers[pos].waketime = waketime;
-    if (waketime < pr->next_timer)
+    if (waketime < pr->next_timer) {
         pr->next_timer = waketime;
+        if (pr->heap_pos >= 0)
+            prt_timer_update(pr);
+    }
+}
+
+// Invoke any timer callbacks that are due
+static void
+pollreactor_run_timers(struct pollreactor *pr, double eventtime)
+{
+    pr->next_timer = PR_NEVER;
+    int i;
+    for (i=0; i<pr->num_timers; i++) {
+        struct pollreactor_timer *timer = &pr->timers[i];
+        double t = timer->waketime;
+        if (eventtime >= t) {
+            t = timer->callback(pr->callback_data, eventtime);
+            timer->waketime = t;
+        }
+        if (t < pr->next_timer)
+            pr->next_timer = t;
+    }
 }
 
 // Internal code to invoke timer callbacks
@@ -102,20 +148,8 @@ static int
 pollreactor_check_timers(struct pollreactor *pr, double eventtime, int busy)
 {
     if (eventtime >= pr->next_timer) {
-        // Find and run pending timers
-        pr->next_timer = PR_NEVER;
-        int i;
-        for (i=0; i<pr->num_timers; i++) {
-            struct pollreactor_timer *timer = &pr->timers[i];
-            double t = timer->waketime;
-            if (eventtime >= t) {
-                busy = 1;
-                t = timer->callback(pr->callback_data, eventtime);
-                timer->waketime = t;
-            }
-            if (t < pr->next_timer)
-                pr->next_timer = t;
-        }
+        busy = 1;
+        pollreactor_run_timers(pr, eventtime);
     }
     if (busy)
         return 0;
@@ -162,6 +196,350 @@ pollreactor_is_exit(struct pollreactor *pr)
     return pr->must_exit;
 }
 
+/****************************************************************
+ * Shared reactor thread
+ ****************************************************************/
+
+// Multiple pollreactor objects may be run from a single background
+// thread.  The file descriptors of all member reactors are monitored
+// with a single epoll instance and the members are kept in a min-heap
+// ordered by their next timer wake-up time.
+
+struct pollreactor_thread {
+    pthread_t tid;
+    int epoll_fd, pipe_fds[2], must_exit;
+    char name[16];
+    // Members (only accessed from the background thread)
+    struct list_head members;
+    struct pollreactor **heap;
+    int heap_count, heap_size;
+
+    pthread_mutex_t lock; // protects variables below
+    pthread_cond_t cond;
+    struct list_head pending;
+};
+
+#define PRT_MAX_EVENTS 16
+
+// Move a heap entry towards the root until the heap is ordered
+static void
+prt_heap_up(struct pollreactor_thread *prt, int pos)
+{
+    struct pollreactor *pr = prt->heap[pos];
+    while (pos) {
+        int parent = (pos - 1) / 2;
+        struct pollreactor *ppr = prt->heap[parent];
+        if (ppr->next_timer <= pr->next_timer)
+            break;
+        prt->heap[pos] = ppr;
+        ppr->heap_pos = pos;
+        pos = parent;
+    }
+    prt->heap[pos] = pr;
+    pr->heap_pos = pos;
+}
+
+// Move a heap entry towards the leaves until the heap is ordered
+static void
+prt_heap_down(struct pollreactor_thread *prt, int pos)
+{
+    struct pollreactor *pr = prt->heap[pos];
+    for (;;) {
+        int child = pos * 2 + 1;
+        if (child >= prt->heap_count)
+            break;
+        if (child + 1 < prt->heap_count && (prt->heap[child + 1]->next_timer
+                                            < prt->heap[child]->next_timer))
+            child++;
+        struct pollreactor *cpr = prt->heap[child];
+        if (pr->next_timer <= cpr->next_timer)
+            break;
+        prt->heap[pos] = cpr;
+        cpr->heap_pos = pos;
+        pos = child;
+    }
+    prt->heap[pos] = pr;
+    pr->heap_pos = pos;
+}
+
+// Add a member reactor to the timer heap
+static void
+prt_heap_insert(struct pollreactor_thread *prt, struct pollreactor *pr)
+{
+    if (prt->heap_count >= prt->heap_size) {
+        int new_size = prt->heap_size ? prt->heap_size * 2 : 8;
+        struct pollreactor **nh = realloc(prt->heap, new_size * sizeof(*nh));
+        if (!nh) {
+            errorf("pollreactor: unable to allocate memory");
+            return;
+        }
+        prt->heap = nh;
+        prt->heap_size = new_size;
+    }
+    prt->heap[prt->heap_count] = pr;
+    prt_heap_up(prt, prt->heap_count++);
+}
+
+// Remove a member reactor from the timer heap
+static void
+prt_heap_remove(struct pollreactor_thread *prt, struct pollreactor *pr)
+{
+    int pos = pr->heap_pos;
+    if (pos < 0)
+        return;
+    pr->heap_pos = -1;
+    struct pollreactor *last = prt->heap[--prt->heap_count];
+    if (last == pr)
+        return;
+    prt->heap[pos] = last;
+    last->heap_pos = pos;
+    prt_heap_up(prt, pos);
+    prt_heap_down(prt, last->heap_pos);
+}
+
+// Note that a member's next wake-up time has moved earlier
+static void
+prt_timer_update(struct pollreactor *pr)
+{
+    prt_heap_up(pr->prt, pr->heap_pos);
+}
+
+// Start monitoring the file descriptors of newly added members
+static void
+prt_add_pending(struct pollreactor_thread *prt)
+{
+    pthread_mutex_lock(&prt->lock);
+    while (!list_empty(&prt->pending)) {
+        struct pollreactor *pr = list_first_entry(
+            &prt->pending, struct pollreactor, prt_node);
+        list_del(&pr->prt_node);
+        list_add_tail(&pr->prt_node, &prt->members);
+        int i;
+        for (i=0; i<pr->num_fds; i++) {
+            if (!(pr->fds[i].events & POLLIN))
+                continue;
+            struct epoll_event ev = {
+                .events = EPOLLIN, .data.ptr = &pr->fd_refs[i] };
+            int ret = epoll_ctl(prt->epoll_fd, EPOLL_CTL_ADD
+                                , pr->fds[i].fd, &ev);
+            if (ret < 0 && errno != EPERM)
+                report_errno("epoll_ctl add", ret);
+        }
+        pr->prt_state = PRS_ACTIVE;
+        prt_heap_insert(prt, pr);
+    }
+    pthread_mutex_unlock(&prt->lock);
+}
+
+// Stop monitoring a member and notify its owner
+static void
+prt_finish_member(struct pollreactor_thread *prt, struct pollreactor *pr)
+{
+    int i;
+    for (i=0; i<pr->num_fds; i++)
+        if (pr->fds[i].events & POLLIN)
+            epoll_ctl(prt->epoll_fd, EPOLL_CTL_DEL, pr->fds[i].fd, NULL);
+    prt_heap_remove(prt, pr);
+    list_del(&pr->prt_node);
+    pr->must_exit = 1;
+    if (pr->exit_callback)
+        pr->exit_callback(pr->callback_data);
+    pthread_mutex_lock(&prt->lock);
+    pr->prt_state = PRS_DONE;
+    pthread_cond_broadcast(&prt->cond);
+    pthread_mutex_unlock(&prt->lock);
+}
+
+// Run any member timers that are due (each member at most once)
+static int
+prt_check_timers(struct pollreactor_thread *prt, double eventtime, int busy)
+{
+    // Due members are moved to the unused slots at the end of the heap
+    int orig_count = prt->heap_count, i;
+    while (prt->heap_count && eventtime >= prt->heap[0]->next_timer) {
+        struct pollreactor *pr = prt->heap[0];
+        prt_heap_remove(prt, pr);
+        prt->heap[prt->heap_count] = pr;
+    }
+    for (i=prt->heap_count; i<orig_count; i++) {
+        struct pollreactor *pr = prt->heap[i];
+        if (!pr->must_exit)
+            pollreactor_run_timers(pr, eventtime);
+    }
+    while (prt->heap_count < orig_count) {
+        prt_heap_up(prt, prt->heap_count++);
+        busy = 1;
+    }
+    if (busy)
+        return 0;
+    if (!prt->heap_count)
+        return 1000;
+    // Calculate sleep duration
+    double timeout = ceil((prt->heap[0]->next_timer - eventtime) * 1000.);
+    return timeout < 1. ? 1 : (timeout > 1000. ? 1000 : (int)timeout);
+}
+
+// Main loop of the shared background thread
+static void *
+prt_background_thread(void *data)
+{
+    struct pollreactor_thread *prt = data;
+    set_thread_name(prt->name);
+    struct epoll_event events[PRT_MAX_EVENTS];
+    double eventtime = get_monotonic();
+    int busy = 1;
+    while (!prt->must_exit) {
+        prt_add_pending(prt);
+        int timeout = prt_check_timers(prt, eventtime, busy);
+        busy = 0;
+        int ret = epoll_wait(prt->epoll_fd, events, ARRAY_SIZE(events)
+                             , timeout);
+        eventtime = get_monotonic();
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            report_errno("epoll_wait", ret);
+            break;
+        }
+        if (ret > 0)
+            busy = 1;
+        int i;
+        for (i=0; i<ret; i++) {
+            struct pollreactor_fdref *ref = events[i].data.ptr;
+            if (!ref) {
+                // Wake-up request
+                char dummy[4096];
+                while (read(prt->pipe_fds[0], dummy, sizeof(dummy)) > 0)
+                    ;
+                continue;
+            }
+            struct pollreactor *pr = ref->pr;
+            if (!pr->must_exit)
+                pr->fd_callbacks[ref->pos](pr->callback_data, eventtime);
+        }
+        // Release any members that have been requested to exit
+        struct pollreactor *pr, *npr;
+        list_for_each_entry_safe(pr, npr, &prt->members, prt_node) {
+            if (pr->must_exit)
+                prt_finish_member(prt, pr);
+        }
+    }
+
+    // Release all remaining members
+    prt_add_pending(prt);
+    while (!list_empty(&prt->members))
+        prt_finish_member(prt, list_first_entry(
+                              &prt->members, struct pollreactor, prt_node));
+    return NULL;
+}
+
+// Wake the shared background thread if it is sleeping
+static void
+prt_kick(struct pollreactor_thread *prt)
+{
+    int ret = write(prt->pipe_fds[1], ".", 1);
+    if (ret < 0)
+        report_errno("pipe write", ret);
+}
+
+// Create a new 'struct pollreactor_thread' and start its thread
+struct pollreactor_thread * __visible
+pollreactor_thread_alloc(char name[16])
+{
+    struct pollreactor_thread *prt = malloc(sizeof(*prt));
+    memset(prt, 0, sizeof(*prt));
+    strncpy(prt->name, name, sizeof(prt->name));
+    prt->name[sizeof(prt->name)-1] = '\0';
+    list_init(&prt->members);
+    list_init(&prt->pending);
+    prt->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (prt->epoll_fd < 0) {
+        report_errno("epoll_create1", prt->epoll_fd);
+        goto fail;
+    }
+    int ret = pipe(prt->pipe_fds);
+    if (ret) {
+        report_errno("pipe", ret);
+        goto fail;
+    }
+    fd_set_non_blocking(prt->pipe_fds[0]);
+    fd_set_non_blocking(prt->pipe_fds[1]);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    ret = epoll_ctl(prt->epoll_fd, EPOLL_CTL_ADD, prt->pipe_fds[0], &ev);
+    if (ret < 0) {
+        report_errno("epoll_ctl add", ret);
+        goto fail;
+    }
+    pthread_mutex_init(&prt->lock, NULL);
+    pthread_cond_init(&prt->cond, NULL);
+    ret = pthread_create(&prt->tid, NULL, prt_background_thread, prt);
+    if (ret) {
+        report_errno("pthread_create", ret);
+        goto fail;
+    }
+    return prt;
+
+fail:
+    free(prt);
+    return NULL;
+}
+
+// Stop the shared background thread and free its resources
+void __visible
+pollreactor_thread_free(struct pollreactor_thread *prt)
+{
+    if (!prt)
+        return;
+    prt->must_exit = 1;
+    prt_kick(prt);
+    int ret = pthread_join(prt->tid, NULL);
+    if (ret)
+        report_errno("pthread_join", ret);
+    close(prt->epoll_fd);
+    close(prt->pipe_fds[0]);
+    close(prt->pipe_fds[1]);
+    free(prt->heap);
+    free(prt);
+}
+
+// Run a pollreactor from a shared background thread.  The
+// exit_callback is invoked from that thread once the reactor has
+// been requested to exit (via pollreactor_do_exit()).
+int
+pollreactor_thread_add(struct pollreactor_thread *prt, struct pollreactor *pr
+                       , void *exit_callback)
+{
+    pr->fd_refs = malloc(pr->num_fds * sizeof(*pr->fd_refs));
+    if (!pr->fd_refs)
+        return -1;
+    int i;
+    for (i=0; i<pr->num_fds; i++) {
+        pr->fd_refs[i].pr = pr;
+        pr->fd_refs[i].pos = i;
+    }
+    pr->prt = prt;
+    pr->exit_callback = exit_callback;
+    pthread_mutex_lock(&prt->lock);
+    pr->prt_state = PRS_PENDING;
+    list_add_tail(&pr->prt_node, &prt->pending);
+    pthread_mutex_unlock(&prt->lock);
+    prt_kick(prt);
+    return 0;
+}
+
+// Wait for a reactor run from a shared thread to complete its exit
+void
+pollreactor_wait_exit(struct pollreactor *pr)
+{
+    struct pollreactor_thread *prt = pr->prt;
+    if (!prt)
+        return;
+    pthread_mutex_lock(&prt->lock);
+    while (pr->prt_state != PRS_DONE)
+        pthread_cond_wait(&prt->cond, &prt->lock);
+    pthread_mutex_unlock(&prt->lock);
+}
+
 int
 fd_set_non_blocking(int fd)
 {
@@ -15,6 +15,11 @@ void pollreactor_update_timer(struct pollreactor *pr, int pos, double waketime);
 void pollreactor_run(struct pollreactor *pr);
 void pollreactor_do_exit(struct pollreactor *pr);
 int pollreactor_is_exit(struct pollreactor *pr);
+struct pollreactor_thread *pollreactor_thread_alloc(char name[16]);
+void pollreactor_thread_free(struct pollreactor_thread *prt);
+int pollreactor_thread_add(struct pollreactor_thread *prt
+                           , struct pollreactor *pr, void *exit_callback);
+void pollreactor_wait_exit(struct pollreactor *pr);
 int fd_set_non_blocking(int fd);
 
 #endif // pollreactor.h
@@ -0,0 +1,350 @@
+// Timer heap and epoll based event wait for the python reactor
+//
+// Copyright (C) 2026  The Klipper developers
+//
+// This file may be distributed under the terms of the GNU GPLv3 license.
+
+#include <errno.h> // errno
+#include <math.h> // ceil
+#include <stdlib.h> // malloc
+#include <string.h> // memset
+#include <sys/epoll.h> // epoll_wait
+#include <unistd.h> // close
+#include "compiler.h" // __visible
+#include "pollreactor.h" // PR_NEVER
+#include "pyhelper.h" // get_monotonic
+
+// The python reactor (klippy/reactor.py) stores the wake up time of
+// each of its timers here.  A single call to reactor_poll() then
+// sleeps until the next timer or file descriptor event and reports
+// the file descriptors that are ready and the timers that are due.
+
+#define REACTOR_MAX_FD_EVENTS 16
+#define REACTOR_MAX_TIMERS 32
+#define REACTOR_MAX_FILES 4
+
+struct reactor_poll_result {
+    double eventtime;
+    int fd_count, timer_count;
+    int fds[REACTOR_MAX_FD_EVENTS], fd_events[REACTOR_MAX_FD_EVENTS];
+    int timers[REACTOR_MAX_TIMERS];
+};
+
+struct reactor_timer {
+    double waketime;
+    uint64_t reg_seq;
+    int heap_pos; // -1 if not scheduled, -2 if not allocated
+};
+
+struct reactor_file {
+    int fd, events;
+};
+
+struct reactor {
+    int epoll_fd;
+    // Regular files (which do not support epoll and are always ready)
+    struct reactor_file files[REACTOR_MAX_FILES];
+    int file_count;
+    // Timers (indexed by timer id)
+    struct reactor_timer *timers;
+    int timer_size, free_id;
+    uint64_t reg_seq;
+    // Min-heap of scheduled timer ids (ordered by waketime)
+    int *heap;
+    int heap_count;
+};
+
+enum { RF_READ = 1, RF_WRITE = 2 };
+
+
+/****************************************************************
+ * Timer heap
+ ****************************************************************/
+
+static inline int
+timer_before(struct reactor *r, int id1, int id2)
+{
+    return r->timers[id1].waketime < r->timers[id2].waketime;
+}
+
+static void
+heap_set(struct reactor *r, int pos, int id)
+{
+    r->heap[pos] = id;
+    r->timers[id].heap_pos = pos;
+}
+
+// Move a heap entry towards the root until the heap is ordered
+static void
+heap_up(struct reactor *r, int pos)
+{
+    int id = r->heap[pos];
+    while (pos) {
+        int parent = (pos - 1) / 2;
+        if (!timer_before(r, id, r->heap[parent]))
+            break;
+        heap_set(r, pos, r->heap[parent]);
+        pos = parent;
+    }
+    heap_set(r, pos, id);
+}
+
+// Move a heap entry towards the leaves until the heap is ordered
+static void
+heap_down(struct reactor *r, int pos)
+{
+    int id = r->heap[pos];
+    for (;;) {
+        int child = pos * 2 + 1;
+        if (child >= r->heap_count)
+            break;
+        if (child + 1 < r->heap_count
+            && timer_before(r, r->heap[child + 1], r->heap[child]))
+            child++;
+        if (!timer_before(r, r->heap[child], id))
+            break;
+        heap_set(r, pos, r->heap[child]);
+        pos = child;
+    }
+    heap_set(r, pos, id);
+}
+
+// Remove a timer from the heap
+static void
+heap_remove(struct reactor *r, int id)
+{
+    int pos = r->timers[id].heap_pos;
+    if (pos < 0)
+        return;
+    r->timers[id].heap_pos = -1;
+    int last = r->heap[--r->heap_count];
+    if (last == id)
+        return;
+    heap_set(r, pos, last);
+    heap_up(r, pos);
+    heap_down(r, r->timers[last].heap_pos);
+}
+
+// Grow the timer storage arrays
+static int
+expand_timers(struct reactor *r)
+{
+    int new_size = r->timer_size ? r->timer_size * 2 : 64;
+    struct reactor_timer *nt = realloc(r->timers, new_size * sizeof(*nt));
+    if (!nt)
+        return -1;
+    r->timers = nt;
+    int *nh = realloc(r->heap, new_size * sizeof(*nh));
+    if (!nh)
+        return -1;
+    r->heap = nh;
+    int i;
+    for (i=r->timer_size; i<new_size; i++)
+        r->timers[i].heap_pos = -2;
+    r->timer_size = new_size;
+    return 0;
+}
+
+
+/****************************************************************
+ * Interface
+ ****************************************************************/
+
+// Allocate a new 'struct reactor' object
+struct reactor * __visible
+reactor_alloc(void)
+{
+    struct reactor *r = malloc(sizeof(*r));
+    memset(r, 0, sizeof(*r));
+    r->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (r->epoll_fd < 0) {
+        report_errno("epoll_create1", r->epoll_fd);
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+// Free memory associated with a 'struct reactor' object
+void __visible
+reactor_free(struct reactor *r)
+{
+    if (!r)
+        return;
+    close(r->epoll_fd);
+    free(r->timers);
+    free(r->heap);
+    free(r);
+}
+
+// Set (or clear) the wake up time of a timer
+void __visible
+reactor_update_timer(struct reactor *r, int id, double waketime)
+{
+    if (id < 0 || id >= r->timer_size || r->timers[id].heap_pos == -2)
+        return;
+    struct reactor_timer *t = &r->timers[id];
+    if (waketime >= PR_NEVER) {
+        heap_remove(r, id);
+        t->waketime = waketime;
+        return;
+    }
+    double prev = t->waketime;
+    t->waketime = waketime;
+    if (t->heap_pos < 0) {
+        heap_set(r, r->heap_count, id);
+        heap_up(r, r->heap_count++);
+    } else if (waketime < prev) {
+        heap_up(r, t->heap_pos);
+    } else {
+        heap_down(r, t->heap_pos);
+    }
+}
+
+// Create a new timer (returns the timer id)
+int __visible
+reactor_add_timer(struct reactor *r, double waketime)
+{
+    int id;
+    for (id=r->free_id; id<r->timer_size; id++)
+        if (r->timers[id].heap_pos == -2)
+            break;
+    if (id >= r->timer_size && expand_timers(r)) {
+        errorf("reactor: unable to allocate memory");
+        return -1;
+    }
+    r->free_id = id + 1;
+    struct reactor_timer *t = &r->timers[id];
+    t->heap_pos = -1;
+    t->waketime = PR_NEVER;
+    t->reg_seq = r->reg_seq++;
+    reactor_update_timer(r, id, waketime);
+    return id;
+}
+
+// Release a timer
+void __visible
+reactor_remove_timer(struct reactor *r, int id)
+{
+    if (id < 0 || id >= r->timer_size || r->timers[id].heap_pos == -2)
+        return;
+    heap_remove(r, id);
+    r->timers[id].heap_pos = -2;
+    if (id < r->free_id)
+        r->free_id = id;
+}
+
+// Track the events of an fd that does not support epoll
+static int
+set_file_events(struct reactor *r, int fd, int events)
+{
+    int i;
+    for (i=0; i<r->file_count; i++)
+        if (r->files[i].fd == fd)
+            break;
+    if (i >= r->file_count) {
+        if (!events)
+            return 0;
+        if (r->file_count >= REACTOR_MAX_FILES) {
+            errorf("reactor: too many regular files");
+            return -1;
+        }
+        r->file_count++;
+    } else if (!events) {
+        r->files[i] = r->files[--r->file_count];
+        return 0;
+    }
+    r->files[i].fd = fd;
+    r->files[i].events = events;
+    return 0;
+}
+
+// Set the events (RF_READ and/or RF_WRITE) to wait for on an fd
+int __visible
+reactor_set_fd(struct reactor *r, int fd, int events)
+{
+    int i;
+    for (i=0; i<r->file_count; i++)
+        if (r->files[i].fd == fd)
+            return set_file_events(r, fd, events);
+    if (!events) {
+        int ret = epoll_ctl(r->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        if (ret < 0 && errno != ENOENT && errno != EBADF) {
+            report_errno("epoll_ctl del", ret);
+            return -1;
+        }
+        return 0;
+    }
+    struct epoll_event ev = {
+        .events = ((events & RF_READ ? EPOLLIN : 0)
+                   | (events & RF_WRITE ? EPOLLOUT : 0)),
+        .data.fd = fd };
+    int ret = epoll_ctl(r->epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    if (ret < 0 && errno == ENOENT)
+        ret = epoll_ctl(r->epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    if (ret < 0 && errno == EPERM)
+        // Regular files are always ready (as with poll)
+        return set_file_events(r, fd, events);
+    if (ret < 0) {
+        report_errno("epoll_ctl", ret);
+        return -1;
+    }
+    return 0;
+}
+
+// Wait for fd activity (or until the next timer if 'may_sleep' is set)
+// and report the ready file descriptors and due timers.  Due timers
+// are removed from the schedule and reported in registration order.
+int __visible
+reactor_poll(struct reactor *r, int may_sleep
+             , struct reactor_poll_result *res)
+{
+    int timeout = 0;
+    if (may_sleep && !r->file_count) {
+        double eventtime = get_monotonic(), delay = 1.;
+        if (r->heap_count)
+            delay = r->timers[r->heap[0]].waketime - eventtime;
+        delay = delay < .001 ? .001 : (delay > 1. ? 1. : delay);
+        timeout = ceil(delay * 1000.);
+    }
+    struct epoll_event events[REACTOR_MAX_FD_EVENTS];
+    int max_events = REACTOR_MAX_FD_EVENTS - r->file_count;
+    int ret = epoll_wait(r->epoll_fd, events, max_events, timeout);
+    double eventtime = get_monotonic();
+    res->eventtime = eventtime;
+    if (ret < 0) {
+        if (errno != EINTR)
+            report_errno("epoll_wait", ret);
+        ret = 0;
+    }
+    int i;
+    for (i=0; i<ret; i++) {
+        uint32_t ev = events[i].events;
+        res->fds[i] = events[i].data.fd;
+        res->fd_events[i] = (((ev & (EPOLLIN|EPOLLHUP|EPOLLERR)) ? RF_READ : 0)
+                             | (ev & EPOLLOUT ? RF_WRITE : 0));
+    }
+    for (i=0; i<r->file_count; i++, ret++) {
+        res->fds[ret] = r->files[i].fd;
+        res->fd_events[ret] = r->files[i].events;
+    }
+    res->fd_count = ret;
+
+    // Find due timers
+    int count = 0;
+    while (r->heap_count && count < REACTOR_MAX_TIMERS
+           && eventtime >= r->timers[r->heap[0]].waketime) {
+        int id = r->heap[0];
+        heap_remove(r, id);
+        // Insertion sort by registration order
+        uint64_t reg_seq = r->timers[id].reg_seq;
+        int pos = count++;
+        while (pos && r->timers[res->timers[pos-1]].reg_seq > reg_seq) {
+            res->timers[pos] = res->timers[pos-1];
+            pos--;
+        }
+        res->timers[pos] = id;
+    }
+    res->timer_count = count;
+    return ret + count;
+}
@@ -54,6 +54,10 @@ struct transmit_requests {
     uint64_t need_kick_clock, min_release_clock;
 };
 
+#define INFLIGHT_BUCKETS 6
+#define RTT_BUCKETS 16
+#define RTT_BUCKET_MIN 0.0001
+
 struct serialqueue {
     // Input reading
     struct pollreactor *pr;
@@ -67,6 +71,7 @@ struct serialqueue {
     // Threading
     char name[16];
     pthread_t tid;
+    struct pollreactor_thread *prt;
     pthread_mutex_t lock; // protects variables below
     // Baud / clock tracking
     int receive_window;
@@ -78,11 +83,18 @@ struct serialqueue {
     uint64_t ignore_nak_seq, last_ack_seq, retransmit_seq, rtt_sample_seq;
     struct list_head sent_queue;
     double srtt, rttvar, rto;
+    // Adaptive transmit window
+    uint64_t bytes_acked, sent_acked[MESSAGE_SEQ_MASK + 1];
+    uint8_t sent_app_limited[MESSAGE_SEQ_MASK + 1];
+    double bw_filter_time, max_bw[2], rtt_filter_time, min_rtt[2];
+    int send_window, send_window_floor;
+    double window_limited_start, window_limited_time;
     // Pending transmission message queues
     struct list_head ready_queues;
     int ready_bytes, need_ack_bytes, last_ack_bytes;
     struct list_head notify_queue;
     double last_write_fail_time;
+    int exit_after_flush;
     // Fastreader support
     pthread_mutex_t fast_reader_dispatch_lock;
     struct list_head fast_readers;
@@ -90,6 +102,7 @@ struct serialqueue {
     struct list_head old_sent;
     // Stats
     uint32_t bytes_write, bytes_read, bytes_retransmit, bytes_invalid;
+    uint32_t inflight_hist[INFLIGHT_BUCKETS], rtt_hist[RTT_BUCKETS];
 };
 
 #define SQPF_SERIAL 0
@@ -107,6 +120,11 @@ struct serialqueue {
 #define MIN_RTO 0.025
 #define MAX_RTO 5.000
 #define MAX_PENDING_BLOCKS 12
+#define MAX_WINDOW_BLOCKS MESSAGE_SEQ_MASK
+#define MIN_SEND_WINDOW (MESSAGE_MAX * 2)
+#define DEFAULT_SEND_WINDOW (MESSAGE_MAX * MAX_PENDING_BLOCKS)
+#define SEND_WINDOW_GAIN 2.0
+#define WINDOW_FILTER_TIME 2.500
 #define MIN_REQTIME_DELTA 0.100
 #define MIN_BACKGROUND_DELTA 0.005
 #define IDLE_QUERY_TIME 1.0
@@ -185,12 +203,94 @@ calculate_bittime(struct serialqueue *sq, uint32_t bytes)
     }
 }
 
+// Determine the histogram bucket of a value (bucket 'i' holds values
+// less than 'base << i')
+static int
+histogram_bucket(double value, double base, int count)
+{
+    int i;
+    for (i=0; i<count-1; i++, base *= 2.)
+        if (value < base)
+            break;
+    return i;
+}
+
+// Update the transmit window from a round-trip measurement.  The
+// window is sized from the recent maximum delivery rate and minimum
+// round-trip time (a simplified version of the TCP BBR algorithm).
+static void
+update_send_window(struct serialqueue *sq, double eventtime, uint64_t rseq
+                   , double sent_time, int acked_bytes)
+{
+    double rtt = eventtime - sent_time;
+    if (rtt <= 0.)
+        return;
+    sq->rtt_hist[histogram_bucket(rtt, RTT_BUCKET_MIN, RTT_BUCKETS)]++;
+    if (!sq->send_window)
+        return;
+    uint64_t delivered = (sq->bytes_acked
+                          - sq->sent_acked[(rseq - 1) & MESSAGE_SEQ_MASK]);
+    double bw = delivered / rtt;
+
+    // Track windowed min rtt
+    if (eventtime > sq->rtt_filter_time) {
+        sq->min_rtt[1] = sq->min_rtt[0];
+        sq->min_rtt[0] = PR_NEVER;
+        sq->rtt_filter_time = eventtime + WINDOW_FILTER_TIME;
+    }
+    if (rtt < sq->min_rtt[0])
+        sq->min_rtt[0] = rtt;
+    double min_rtt = (sq->min_rtt[0] < sq->min_rtt[1]
+                      ? sq->min_rtt[0] : sq->min_rtt[1]);
+
+    // Track windowed max bandwidth.  A block sent while no other data
+    // was ready measures the host's send rate, not the link, so such a
+    // sample may only raise the estimate (an idle period, with just the
+    // periodic clock queries, must not shrink the window).
+    double max_bw = (sq->max_bw[0] > sq->max_bw[1]
+                     ? sq->max_bw[0] : sq->max_bw[1]);
+    if (!sq->sent_app_limited[(rseq - 1) & MESSAGE_SEQ_MASK] || bw > max_bw) {
+        if (eventtime > sq->bw_filter_time) {
+            sq->max_bw[1] = sq->max_bw[0];
+            sq->max_bw[0] = 0.;
+            sq->bw_filter_time = eventtime + WINDOW_FILTER_TIME;
+        }
+        if (bw > sq->max_bw[0])
+            sq->max_bw[0] = bw;
+        max_bw = (sq->max_bw[0] > sq->max_bw[1]
+                  ? sq->max_bw[0] : sq->max_bw[1]);
+    }
+
+    // After a retransmit timeout the window floor is raised by about
+    // one block per window of acknowledged data until it again reaches
+    // the fixed MAX_PENDING_BLOCKS limit
+    int min_window = sq->send_window_floor;
+    if (min_window < DEFAULT_SEND_WINDOW) {
+        min_window += ((MESSAGE_MAX * acked_bytes + min_window - 1)
+                       / min_window);
+        if (min_window > DEFAULT_SEND_WINDOW)
+            min_window = DEFAULT_SEND_WINDOW;
+        sq->send_window_floor = min_window;
+    }
+
+    // Calculate new window.  Queuing on a loaded link inflates the rtt
+    // and limits the estimate, so the estimate may only raise the
+    // window above the floor (the mcu receive_window is enforced
+    // separately) and the sequence number space caps it.
+    double window = SEND_WINDOW_GAIN * max_bw * min_rtt;
+    if (window < min_window)
+        window = min_window;
+    else if (window > MESSAGE_MAX * MAX_WINDOW_BLOCKS)
+        window = MESSAGE_MAX * MAX_WINDOW_BLOCKS;
+    sq->send_window = window;
+}
+
 // Update internal state when the receive sequence increases
 static void
 update_receive_seq(struct serialqueue *sq, double eventtime, uint64_t rseq)
 {
     // Remove from sent queue
-    uint64_t sent_seq = sq->receive_seq;
+    uint64_t sent_seq = sq->receive_seq, prev_acked = sq->bytes_acked;
     for (;;) {
         struct queue_message *sent = list_first_entry(
             &sq->sent_queue, struct queue_message, node);
@@ -204,10 +304,14 @@ update_receive_seq(struct serialqueue *sq, double eventtime, uint64_t rseq)
         list_del(&sent->node);
         debug_queue_add(&sq->old_sent, sent);
         sent_seq++;
+        sq->bytes_acked += sent->len;
         if (rseq == sent_seq) {
             // Found sent message corresponding with the received sequence
             sq->last_receive_sent_time = sent->receive_time;
             sq->last_ack_bytes = sent->len;
+            if (rseq > sq->retransmit_seq)
+                update_send_window(sq, eventtime, rseq, sent->sent_time
+                                   , sq->bytes_acked - prev_acked);
             break;
         }
     }
@@ -285,6 +389,17 @@ handle_message(struct serialqueue *sq, double eventtime, int len)
         list_add_tail(&qm->node, &received);
     }
 
+    // Check fast readers
+    struct fastreader *fr = NULL, *iter;
+    list_for_each_entry(iter, &sq->fast_readers, node) {
+        if (len < iter->prefix_len + MESSAGE_MIN
+            || memcmp(&sq->input_buf[MESSAGE_HEADER_SIZE]
+                      , iter->prefix, iter->prefix_len) != 0)
+            continue;
+        fr = iter;
+        break;
+    }
+
     // Process message
     if (len == MESSAGE_MIN) {
         // Ack/nak message
@@ -293,7 +408,7 @@ handle_message(struct serialqueue *sq, double eventtime, int len)
         else if (rseq > sq->ignore_nak_seq && !list_empty(&sq->sent_queue))
             // Duplicate Ack is a Nak - do fast retransmit
             pollreactor_update_timer(sq->pr, SQPT_RETRANSMIT, PR_NOW);
-    } else {
+    } else if (!fr || !fr->exclusive) {
         // Data message - add to receive queue
         struct queue_message *qm = message_fill(sq->input_buf, len);
         qm->sent_time = (rseq > sq->retransmit_seq
@@ -306,14 +421,8 @@ handle_message(struct serialqueue *sq, double eventtime, int len)
     if (!list_empty(&received))
         receive_append_wake(&sq->receiver, &received);
 
-    // Check fast readers
-    struct fastreader *fr;
-    list_for_each_entry(fr, &sq->fast_readers, node) {
-        if (len < fr->prefix_len + MESSAGE_MIN
-            || memcmp(&sq->input_buf[MESSAGE_HEADER_SIZE]
-                      , fr->prefix, fr->prefix_len) != 0)
-            continue;
-        // Release main lock and invoke callback
+    if (fr) {
+        // Release main lock and invoke fast reader callback
         pthread_mutex_lock(&sq->fast_reader_dispatch_lock);
         pthread_mutex_unlock(&sq->lock);
         fr->func(fr, eventtime, sq->input_buf, len);
@@ -432,7 +541,7 @@ retransmit_event(struct serialqueue *sq, double eventtime)
     pthread_mutex_lock(&sq->lock);
 
     // Retransmit all pending messages
-    uint8_t buf[MESSAGE_MAX * MAX_PENDING_BLOCKS + 1];
+    uint8_t buf[MESSAGE_MAX * MAX_WINDOW_BLOCKS + 1];
     int buflen = 0, first_buflen = 0;
     buf[buflen++] = MESSAGE_SYNC;
     struct queue_message *qm;
@@ -457,6 +566,15 @@ retransmit_event(struct serialqueue *sq, double eventtime)
         sq->rto *= 2.0;
         if (sq->rto > MAX_RTO)
             sq->rto = MAX_RTO;
+        // Halve the transmit window (below the fixed limit if needed)
+        // and restart bandwidth measurements
+        if (sq->send_window) {
+            int window = sq->send_window / 2;
+            if (window < MIN_SEND_WINDOW)
+                window = MIN_SEND_WINDOW;
+            sq->send_window = sq->send_window_floor = window;
+            sq->max_bw[0] = sq->max_bw[1] = 0.;
+        }
         sq->ignore_nak_seq = sq->send_seq;
     }
     sq->retransmit_seq = sq->send_seq;
@@ -527,6 +645,10 @@ build_and_send_command(struct serialqueue *sq, uint8_t *buf, int pending
         pollreactor_update_timer(sq->pr, SQPT_RETRANSMIT, idletime + sq->rto);
     if (!sq->rtt_sample_seq)
         sq->rtt_sample_seq = sq->send_seq;
+    sq->sent_acked[sq->send_seq & MESSAGE_SEQ_MASK] = sq->bytes_acked;
+    sq->sent_app_limited[sq->send_seq & MESSAGE_SEQ_MASK] = !sq->ready_bytes;
+    sq->inflight_hist[histogram_bucket(sq->need_ack_bytes, MESSAGE_MAX
+                                       , INFLIGHT_BUCKETS)]++;
     sq->send_seq++;
     sq->need_ack_bytes += len;
     list_add_tail(&out->node, &sq->sent_queue);
@@ -589,6 +711,31 @@ update_need_kick_clock(struct serialqueue *sq, uint64_t wantclock)
     return 0;
 }
 
+// Check if the transmit windows permit sending another message block
+static int
+check_send_window(struct serialqueue *sq)
+{
+    // With an adaptive window, the byte window limits the data in
+    // flight and only the sequence number space limits the block count
+    int max_blocks = sq->send_window ? MAX_WINDOW_BLOCKS : MAX_PENDING_BLOCKS;
+    if (sq->send_seq - sq->receive_seq >= max_blocks
+        && sq->receive_seq != (uint64_t)-1)
+        // Need an ack before more messages can be sent
+        return 0;
+    if (sq->send_seq <= sq->receive_seq)
+        return 1;
+    if (sq->receive_window) {
+        int need_ack_bytes = sq->need_ack_bytes + MESSAGE_MAX;
+        if (sq->last_ack_seq < sq->receive_seq)
+            need_ack_bytes += sq->last_ack_bytes;
+        if (need_ack_bytes > sq->receive_window)
+            return 0;
+    }
+    if (sq->send_window && sq->need_ack_bytes + MESSAGE_MAX > sq->send_window)
+        return 0;
+    return 1;
+}
+
 // Determine if ready to send commands (or the amount of time to sleep if not)
 static double
 check_send_command(struct serialqueue *sq, int pending, double eventtime)
@@ -600,17 +747,15 @@ check_send_command(struct serialqueue *sq, int pending, double eventtime)
     uint64_t min_stalled_clock = check_upcoming_queues(sq, ack_clock);
 
     // Check if valid to send messages
-    if (sq->send_seq - sq->receive_seq >= MAX_PENDING_BLOCKS
-        && sq->receive_seq != (uint64_t)-1)
-        // Need an ack before more messages can be sent
+    if (!check_send_window(sq)) {
+        // Wait for ack from past messages before sending next message
+        if (!sq->window_limited_start)
+            sq->window_limited_start = eventtime;
         return eventtime + 0.250;
-    if (sq->send_seq > sq->receive_seq && sq->receive_window) {
-        int need_ack_bytes = sq->need_ack_bytes + MESSAGE_MAX;
-        if (sq->last_ack_seq < sq->receive_seq)
-            need_ack_bytes += sq->last_ack_bytes;
-        if (need_ack_bytes > sq->receive_window)
-            // Wait for ack from past messages before sending next message
-            return eventtime + 0.250;
+    }
+    if (sq->window_limited_start) {
+        sq->window_limited_time += eventtime - sq->window_limited_start;
+        sq->window_limited_start = 0.;
     }
 
     // Check if a block is fully ready to send
@@ -664,7 +809,7 @@ static double
 command_event(struct serialqueue *sq, double eventtime)
 {
     pthread_mutex_lock(&sq->lock);
-    uint8_t buf[MESSAGE_MAX * MAX_PENDING_BLOCKS];
+    uint8_t buf[MESSAGE_MAX * MAX_WINDOW_BLOCKS];
     int buflen = 0;
     double waketime;
     for (;;) {
@@ -682,11 +827,24 @@ command_event(struct serialqueue *sq, double eventtime)
         double idletime = eventtime > sq->idle_time ? eventtime : sq->idle_time;
         sq->idle_time = idletime + calculate_bittime(sq, buflen);
         waketime = PR_NOW;
+    } else if (sq->exit_after_flush) {
+        // All messages queued before the exit request have been written
+        pollreactor_do_exit(sq->pr);
     }
     pthread_mutex_unlock(&sq->lock);
     return waketime;
 }
 
+// Final processing after the background reactor has been requested to exit
+static void
+background_exit(struct serialqueue *sq)
+{
+    // Wake any waiting receivers
+    struct list_head dummy;
+    list_init(&dummy);
+    receive_append_wake(&sq->receiver, &dummy);
+}
+
 // Main background thread for reading/writing to serial port
 static void *
 background_thread(void *data)
@@ -694,19 +852,14 @@ background_thread(void *data)
     struct serialqueue *sq = data;
     set_thread_name(sq->name);
     pollreactor_run(sq->pr);
-
-    // Wake any waiting receivers
-    struct list_head dummy;
-    list_init(&dummy);
-    receive_append_wake(&sq->receiver, &dummy);
-
+    background_exit(sq);
     return NULL;
 }
 
 // Create a new 'struct serialqueue' object
 struct serialqueue * __visible
 serialqueue_alloc(int serial_fd, char serial_fd_type, int client_id
-                  , char name[16])
+                  , char name[16], struct pollreactor_thread *prt)
 {
     struct serialqueue *sq = malloc(sizeof(*sq));
     memset(sq, 0, sizeof(*sq));
@@ -773,6 +926,14 @@ serialqueue_alloc(int serial_fd, char serial_fd_type, int client_id
     ret = pthread_mutex_init(&sq->fast_reader_dispatch_lock, NULL);
     if (ret)
         goto fail;
+    if (prt) {
+        // Run from a background thread shared with other serialqueues
+        sq->prt = prt;
+        ret = pollreactor_thread_add(prt, sq->pr, background_exit);
+        if (ret)
+            goto fail;
+        return sq;
+    }
     ret = pthread_create(&sq->tid, NULL, background_thread, sq);
     if (ret)
         goto fail;
@@ -788,8 +949,20 @@ fail:
 void __visible
 serialqueue_exit(struct serialqueue *sq)
 {
-    pollreactor_do_exit(sq->pr);
+    if (sq->serial_fd_type == SQT_DEBUGFILE) {
+        // Debug output must include every message queued prior to the
+        // exit request - have the background thread exit once written
+        pthread_mutex_lock(&sq->lock);
+        sq->exit_after_flush = 1;
+        pthread_mutex_unlock(&sq->lock);
+    } else {
+        pollreactor_do_exit(sq->pr);
+    }
     kick_bg_thread(sq);
+    if (sq->prt) {
+        pollreactor_wait_exit(sq->pr);
+        return;
+    }
     int ret = pthread_join(sq->tid, NULL);
     if (ret)
         report_errno("pthread_join", ret);
@@ -803,6 +976,7 @@ serialqueue_free(struct serialqueue *sq)
         return;
     if (!pollreactor_is_exit(sq->pr))
         serialqueue_exit(sq);
+    pollreactor_wait_exit(sq->pr);
     pthread_mutex_lock(&sq->lock);
     message_queue_free(&sq->sent_queue);
     pthread_mutex_lock(&sq->receiver.lock);
@@ -1006,6 +1180,19 @@ serialqueue_set_receive_window(struct serialqueue *sq, int receive_window)
     pthread_mutex_unlock(&sq->lock);
 }
 
+// Enable (or disable) sizing the transmit window from the measured
+// delivery rate and round-trip time
+void __visible
+serialqueue_set_adaptive_window(struct serialqueue *sq, int enable)
+{
+    pthread_mutex_lock(&sq->lock);
+    sq->send_window = enable ? DEFAULT_SEND_WINDOW : 0;
+    sq->send_window_floor = DEFAULT_SEND_WINDOW;
+    sq->max_bw[0] = sq->max_bw[1] = 0.;
+    sq->min_rtt[0] = sq->min_rtt[1] = PR_NEVER;
+    pthread_mutex_unlock(&sq->lock);
+}
+
 // Set the estimated clock rate of the mcu on the other end of the
 // serial port
 void __visible
@@ -1026,6 +1213,26 @@ serialqueue_get_clock_est(struct serialqueue *sq, struct clock_estimate *ce)
     pthread_mutex_unlock(&sq->lock);
 }
 
+// Estimate a percentile from the round-trip time histogram
+static double
+histogram_percentile(uint32_t *hist, double percentile)
+{
+    uint32_t total = 0;
+    int i;
+    for (i=0; i<RTT_BUCKETS; i++)
+        total += hist[i];
+    if (!total)
+        return 0.;
+    uint32_t count = 0;
+    double limit = RTT_BUCKET_MIN;
+    for (i=0; i<RTT_BUCKETS-1; i++, limit *= 2.) {
+        count += hist[i];
+        if (count >= total * percentile)
+            break;
+    }
+    return limit;
+}
+
 // Return a string buffer containing statistics for the serial port
 void __visible
 serialqueue_get_stats(struct serialqueue *sq, char *buf, int len)
@@ -1036,18 +1243,32 @@ serialqueue_get_stats(struct serialqueue *sq, char *buf, int len)
     memcpy(&stats, sq, sizeof(stats));
     pthread_mutex_unlock(&sq->transmit_requests.lock);
     pthread_mutex_unlock(&sq->lock);
+    double window_limited_time = stats.window_limited_time;
+    if (stats.window_limited_start)
+        window_limited_time += get_monotonic() - stats.window_limited_start;
+    double rtt_p50, rtt_p90, rtt_p99;
+    rtt_p50 = histogram_percentile(stats.rtt_hist, .50);
+    rtt_p90 = histogram_percentile(stats.rtt_hist, .90);
+    rtt_p99 = histogram_percentile(stats.rtt_hist, .99);
+    uint32_t *ih = stats.inflight_hist;
 
     snprintf(buf, len, "bytes_write=%u bytes_read=%u"
              " bytes_retransmit=%u bytes_invalid=%u"
              " send_seq=%u receive_seq=%u retransmit_seq=%u"
              " srtt=%.3f rttvar=%.3f rto=%.3f"
              " ready_bytes=%u upcoming_bytes=%u"
+             " send_window=%d window_limited_time=%.3f"
+             " rtt_p50=%.4f rtt_p90=%.4f rtt_p99=%.4f"
+             " inflight_hist=%u,%u,%u,%u,%u,%u"
              , stats.bytes_write, stats.bytes_read
              , stats.bytes_retransmit, stats.bytes_invalid
              , (int)stats.send_seq, (int)stats.receive_seq
              , (int)stats.retransmit_seq
              , stats.srtt, stats.rttvar, stats.rto
-             , stats.ready_bytes, stats.transmit_requests.upcoming_bytes);
+             , stats.ready_bytes, stats.transmit_requests.upcoming_bytes
+             , stats.send_window, window_limited_time
+             , rtt_p50, rtt_p90, rtt_p99
+             , ih[0], ih[1], ih[2], ih[3], ih[4], ih[5]);
 }
 
 // Extract old messages stored in the debug queues
@@ -15,6 +15,7 @@ typedef void (*fastreader_cb)(struct fastreader *fr, double eventtime
 struct fastreader {
     struct list_node node;
     fastreader_cb func;
+    int exclusive; // Don't add matching messages to the receive queue
     int prefix_len;
     uint8_t prefix[MESSAGE_MAX];
 };
@@ -27,8 +28,10 @@ struct pull_queue_message {
 };
 
 struct serialqueue;
+struct pollreactor_thread;
 struct serialqueue *serialqueue_alloc(int serial_fd, char serial_fd_type
-                                      , int client_id, char name[16]);
+                                      , int client_id, char name[16]
+                                      , struct pollreactor_thread *prt);
 void serialqueue_exit(struct serialqueue *sq);
 void serialqueue_free(struct serialqueue *sq);
 struct command_queue *serialqueue_alloc_commandqueue(void);
@@ -45,6 +48,7 @@ void serialqueue_send(struct serialqueue *sq, struct command_queue *cq
 void serialqueue_pull(struct serialqueue *sq, struct pull_queue_message *pqm);
 void serialqueue_set_wire_frequency(struct serialqueue *sq, double frequency);
 void serialqueue_set_receive_window(struct serialqueue *sq, int receive_window);
+void serialqueue_set_adaptive_window(struct serialqueue *sq, int enable);
 void serialqueue_set_clock_est(struct serialqueue *sq, double est_freq
                                , double conv_time, uint64_t conv_clock);
 void serialqueue_get_clock_est(struct serialqueue *sq
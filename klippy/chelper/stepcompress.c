@@ -29,9 +29,11 @@
 #define QUEUE_START_SIZE 1024
 
 // Storage for queuing steps (only lower 32 bits of step clock are stored as
-// optimization to reduce memory, improve cache usage, and reduce 64 bit ops)
+// optimization to reduce memory, improve cache usage, and reduce 64 bit ops).
+// The minimum acceptable clock of each step (as limited by the distance
+// to the previous step) is calculated once when the step is queued.
 struct qstep {
-    uint32_t clock32;
+    uint32_t clock32, min_clock32;
 };
 
 // Main stepcompress object storage
@@ -39,13 +41,15 @@ struct stepcompress {
     // Buffer management
     struct qstep *queue, *queue_end, *queue_pos, *queue_next;
     // Internal tracking
-    uint32_t max_error;
+    uint32_t max_error, lookahead;
     double mcu_time_offset, mcu_freq, last_step_print_time;
     // Message generation
     uint64_t last_step_clock;
     struct list_head *msg_queue;
     uint32_t oid;
     int32_t queue_step_msgtag, set_next_step_dir_msgtag;
+    int32_t queue_step_delta_msgtag;
+    uint32_t predict_interval;
     int sdir, invert_sdir;
     // Step+dir+step filter
     uint64_t next_step_clock;
@@ -53,6 +57,8 @@ struct stepcompress {
     // History tracking
     int64_t last_position;
     struct list_head history_list;
+    // Statistics
+    uint64_t step_count, queue_step_count;
 };
 
 // Parameters of a single queue_step command
@@ -92,32 +98,42 @@ struct points {
 };
 
 // Given a requested step time, return the minimum and maximum
-// acceptable times
+// acceptable times (for a sequence starting at 'qpos' and 'lsc')
 static inline struct points
-minmax_point(struct stepcompress *sc, struct qstep *pos)
+minmax_point_from(struct stepcompress *sc, struct qstep *qpos, uint32_t lsc
+                  , struct qstep *pos)
 {
-    uint32_t lsc = sc->last_step_clock, point = pos->clock32 - lsc;
-    uint32_t prevpoint = pos > sc->queue_pos ? (pos-1)->clock32 - lsc : 0;
-    uint32_t max_error = (point - prevpoint) / 2;
+    uint32_t point = pos->clock32 - lsc;
+    if (pos > qpos)
+        return (struct points){ pos->min_clock32 - lsc, point };
+    // The first step is limited by the distance to last_step_clock
+    uint32_t max_error = point / 2;
     if (max_error > sc->max_error)
         max_error = sc->max_error;
     return (struct points){ point - max_error, point };
 }
 
+static inline struct points
+minmax_point(struct stepcompress *sc, struct qstep *pos)
+{
+    return minmax_point_from(sc, sc->queue_pos, sc->last_step_clock, pos);
+}
+
 // The maximum add delta between two valid quadratic sequences of the
 // form "add*count*(count-1)/2 + interval*count" is "(6 + 4*sqrt(2)) *
 // maxerror / (count*count)".  The "6 + 4*sqrt(2)" is 11.65685, but
 // using 11 works well in practice.
 #define QUADRATIC_DEV 11
 
-// Find a 'step_move' that covers a series of step times
+// Find a 'step_move' that covers a series of step times starting
+// at 'qpos' (with the previous step at clock 'lsc')
 static struct step_move
-compress_bisect_add(struct stepcompress *sc)
+compress_bisect_add(struct stepcompress *sc, struct qstep *qpos, uint32_t lsc)
 {
     struct qstep *qlast = sc->queue_next;
-    if (qlast > sc->queue_pos + 65535)
-        qlast = sc->queue_pos + 65535;
-    struct points point = minmax_point(sc, sc->queue_pos);
+    if (qlast > qpos + 65535)
+        qlast = qpos + 65535;
+    struct points point = minmax_point_from(sc, qpos, lsc, qpos);
     int32_t outer_mininterval = point.minp, outer_maxinterval = point.maxp;
     int32_t add = 0, minadd = -0x8000, maxadd = 0x7fff;
     int32_t bestinterval = 0, bestcount = 1, bestadd = 1, bestreach = INT32_MIN;
@@ -128,15 +144,17 @@ compress_bisect_add(struct stepcompress *sc)
         struct points nextpoint;
         int32_t nextmininterval = outer_mininterval;
         int32_t nextmaxinterval = outer_maxinterval, interval = nextmaxinterval;
-        int32_t nextcount = 1;
+        int32_t nextcount = 1, nextaddfactor = 0;
         for (;;) {
+            nextaddfactor += nextcount;
             nextcount++;
-            if (&sc->queue_pos[nextcount-1] >= qlast) {
+            struct qstep *qs = &qpos[nextcount-1];
+            if (qs >= qlast) {
                 int32_t count = nextcount - 1;
                 return (struct step_move){ interval, count, add };
             }
-            nextpoint = minmax_point(sc, sc->queue_pos + nextcount - 1);
-            int32_t nextaddfactor = nextcount*(nextcount-1)/2;
+            nextpoint.minp = qs->min_clock32 - lsc;
+            nextpoint.maxp = qs->clock32 - lsc;
             int32_t c = add*nextaddfactor;
             if (nextmininterval*nextcount < nextpoint.minp - c)
                 nextmininterval = idiv_up(nextpoint.minp - c, nextcount);
@@ -166,7 +184,6 @@ compress_bisect_add(struct stepcompress *sc)
         }
 
         // Check if a greater or lesser add could extend the sequence
-        int32_t nextaddfactor = nextcount*(nextcount-1)/2;
         int32_t nextreach = add*nextaddfactor + interval*nextcount;
         if (nextreach < nextpoint.minp) {
             minadd = add + 1;
@@ -205,6 +222,47 @@ compress_bisect_add(struct stepcompress *sc)
     return (struct step_move){ bestinterval, bestcount, bestadd };
 }
 
+// Return the clock (relative to the start) of the last step of a move
+static inline uint32_t
+move_ticks(struct step_move *move)
+{
+    int32_t addfactor = move->count*(move->count-1)/2;
+    return move->add*addfactor + move->interval*move->count;
+}
+
+// Find a 'step_move' that minimizes the total number of commands.
+// The longest move from the current position is not always the best
+// choice - ending it a few steps earlier may permit a substantially
+// longer following move.  Evaluate the split points in a small window
+// before the end of the longest move and select the one that covers
+// the most steps with two commands.
+static struct step_move
+compress_lookahead(struct stepcompress *sc)
+{
+    struct qstep *qpos = sc->queue_pos;
+    uint32_t lsc = sc->last_step_clock;
+    struct step_move move = compress_bisect_add(sc, qpos, lsc);
+    if (!sc->lookahead || qpos + move.count >= sc->queue_next
+        || move.count <= 1)
+        return move;
+    int32_t mincount = move.count - sc->lookahead, count = move.count;
+    if (mincount < 1)
+        mincount = 1;
+    int32_t bestcount = count, bestreach = 0;
+    for (; count >= mincount; count--) {
+        struct step_move trunc = { move.interval, count, move.add };
+        struct step_move next = compress_bisect_add(
+            sc, qpos + count, lsc + move_ticks(&trunc));
+        int32_t reach = count + next.count;
+        if (reach > bestreach) {
+            bestcount = count;
+            bestreach = reach;
+        }
+    }
+    move.count = bestcount;
+    return move;
+}
+
 
 /****************************************************************
  * Step compress checking
@@ -273,6 +331,22 @@ stepcompress_fill(struct stepcompress *sc, uint32_t oid, uint32_t max_error
     sc->set_next_step_dir_msgtag = set_next_step_dir_msgtag;
 }
 
+// Send step intervals relative to the end of the previous move
+void __visible
+stepcompress_set_delta(struct stepcompress *sc
+                       , int32_t queue_step_delta_msgtag)
+{
+    sc->queue_step_delta_msgtag = queue_step_delta_msgtag;
+}
+
+// Set the number of alternative split points to evaluate for each
+// queue_step command (0 disables the search)
+void __visible
+stepcompress_set_lookahead(struct stepcompress *sc, uint32_t lookahead)
+{
+    sc->lookahead = lookahead;
+}
+
 // Set the inverted stepper direction flag
 void __visible
 stepcompress_set_invert_sdir(struct stepcompress *sc, uint32_t invert_sdir)
@@ -355,12 +429,20 @@ add_move(struct stepcompress *sc, uint64_t first_clock, struct step_move *move)
     uint32_t msg[5] = {
         sc->queue_step_msgtag, sc->oid, move->interval, move->count, move->add
     };
+    if (sc->queue_step_delta_msgtag) {
+        // The mcu tracks the same interval prediction
+        msg[0] = sc->queue_step_delta_msgtag;
+        msg[2] = move->interval - sc->predict_interval;
+        sc->predict_interval = move->interval + (int32_t)move->add*move->count;
+    }
     struct queue_message *qm = message_alloc_and_encode(msg, 5);
     qm->min_clock = qm->req_clock = sc->last_step_clock;
     if (move->count == 1 && first_clock >= sc->last_step_clock + CLOCK_DIFF_MAX)
         qm->req_clock = first_clock;
     list_add_tail(&qm->node, sc->msg_queue);
     sc->last_step_clock = last_clock;
+    sc->step_count += move->count;
+    sc->queue_step_count++;
 
     // Create and store move in history tracking
     struct history_steps *hs = malloc(sizeof(*hs));
@@ -381,7 +463,7 @@ queue_flush(struct stepcompress *sc, uint64_t move_clock)
     if (sc->queue_pos >= sc->queue_next)
         return 0;
     while (sc->last_step_clock < move_clock) {
-        struct step_move move = compress_bisect_add(sc);
+        struct step_move move = compress_lookahead(sc);
         int ret = check_line(sc, move);
         if (ret)
             return ret;
@@ -427,6 +509,22 @@ set_next_step_dir(struct stepcompress *sc, int sdir)
     return 0;
 }
 
+// Store a step clock at the end of the internal queue
+static inline void
+queue_store(struct stepcompress *sc, uint32_t clock32)
+{
+    struct qstep *qs = sc->queue_next;
+    uint32_t max_error = sc->max_error;
+    if (qs > sc->queue) {
+        uint32_t half_gap = (clock32 - (qs-1)->clock32) / 2;
+        if (half_gap < max_error)
+            max_error = half_gap;
+    }
+    qs->clock32 = clock32;
+    qs->min_clock32 = clock32 - max_error;
+    sc->queue_next = qs + 1;
+}
+
 // Slow path for queue_append() - handle next step far in future
 static int
 queue_append_far(struct stepcompress *sc)
@@ -438,8 +536,7 @@ queue_append_far(struct stepcompress *sc)
         return ret;
     if (step_clock >= sc->last_step_clock + CLOCK_DIFF_MAX)
         return stepcompress_flush_far(sc, step_clock);
-    sc->queue_next->clock32 = step_clock;
-    sc->queue_next++;
+    queue_store(sc, step_clock);
     return 0;
 }
 
@@ -476,8 +573,7 @@ queue_append_extend(struct stepcompress *sc)
         sc->queue_next = sc->queue + in_use;
     }
 
-    sc->queue_next->clock32 = sc->next_step_clock;
-    sc->queue_next++;
+    queue_store(sc, sc->next_step_clock);
     sc->next_step_clock = 0;
     return 0;
 }
@@ -495,8 +591,7 @@ queue_append(struct stepcompress *sc)
         return queue_append_far(sc);
     if (unlikely(sc->queue_next >= sc->queue_end))
         return queue_append_extend(sc);
-    sc->queue_next->clock32 = sc->next_step_clock;
-    sc->queue_next++;
+    queue_store(sc, sc->next_step_clock);
     sc->next_step_clock = 0;
     return 0;
 }
@@ -562,6 +657,7 @@ stepcompress_reset(struct stepcompress *sc, uint64_t last_step_clock)
     if (ret)
         return ret;
     sc->last_step_clock = last_step_clock;
+    sc->predict_interval = 0;
     sc->sdir = -1;
     calc_last_step_print_time(sc);
     return 0;
@@ -615,6 +711,14 @@ stepcompress_find_past_position(struct stepcompress *sc, uint64_t clock)
     return last_position;
 }
 
+// Report the number of steps and queue_step commands generated
+void __visible
+stepcompress_get_stats(struct stepcompress *sc, struct stepcompress_stats *s)
+{
+    s->step_count = sc->step_count;
+    s->queue_step_count = sc->queue_step_count;
+}
+
 // Return history of queue_step commands
 int __visible
 stepcompress_extract_old(struct stepcompress *sc, struct pull_history_steps *p
@@ -638,3 +742,45 @@ stepcompress_extract_old(struct stepcompress *sc, struct pull_history_steps *p
     }
     return res;
 }
+
+
+/****************************************************************
+ * Benchmarking support
+ ****************************************************************/
+
+// Compress a series of step clocks using a temporary 'stepcompress'
+// object.  Returns the number of queue_step commands produced.
+int64_t __visible
+stepcompress_replay(uint32_t max_error, uint32_t lookahead
+                    , uint64_t *step_clocks, uint8_t *step_dirs, int count)
+{
+    struct list_head msg_queue;
+    list_init(&msg_queue);
+    struct stepcompress *sc = stepcompress_alloc(&msg_queue);
+    stepcompress_fill(sc, 0, max_error, 0, 0);
+    stepcompress_set_lookahead(sc, lookahead);
+    int64_t res = 0;
+    int i;
+    for (i=0; i<count; i++) {
+        sc->next_step_clock = step_clocks[i];
+        sc->next_step_dir = step_dirs[i];
+        int ret = queue_append(sc);
+        if (ret) {
+            res = ret;
+            break;
+        }
+    }
+    if (!res)
+        res = queue_flush(sc, UINT64_MAX);
+    // Release the generated commands
+    while (!list_empty(&msg_queue)) {
+        struct queue_message *qm = list_first_entry(
+            &msg_queue, struct queue_message, node);
+        list_del(&qm->node);
+        message_free(qm);
+    }
+    if (!res)
+        res = sc->queue_step_count;
+    stepcompress_free(sc);
+    return res;
+}
@@ -11,11 +11,18 @@ struct pull_history_steps {
     int step_count, interval, add;
 };
 
+struct stepcompress_stats {
+    uint64_t step_count, queue_step_count;
+};
+
 struct list_head;
 struct stepcompress *stepcompress_alloc(struct list_head *msg_queue);
 void stepcompress_fill(struct stepcompress *sc, uint32_t oid, uint32_t max_error
                        , int32_t queue_step_msgtag
                        , int32_t set_next_step_dir_msgtag);
+void stepcompress_set_delta(struct stepcompress *sc
+                            , int32_t queue_step_delta_msgtag);
+void stepcompress_set_lookahead(struct stepcompress *sc, uint32_t lookahead);
 void stepcompress_set_invert_sdir(struct stepcompress *sc
                                   , uint32_t invert_sdir);
 void stepcompress_history_expire(struct stepcompress *sc, uint64_t end_clock);
@@ -33,8 +40,13 @@ int stepcompress_set_last_position(struct stepcompress *sc, uint64_t clock
                                    , int64_t last_position);
 int64_t stepcompress_find_past_position(struct stepcompress *sc
                                         , uint64_t clock);
+void stepcompress_get_stats(struct stepcompress *sc
+                           , struct stepcompress_stats *s);
 int stepcompress_extract_old(struct stepcompress *sc
                              , struct pull_history_steps *p, int max
                              , uint64_t start_clock, uint64_t end_clock);
+int64_t stepcompress_replay(uint32_t max_error, uint32_t lookahead
+                            , uint64_t *step_clocks, uint8_t *step_dirs
+                            , int count);
 
 #endif // stepcompress.h
@@ -13,6 +13,7 @@
 
 #include <pthread.h> // pthread_mutex_lock
 #include <stddef.h> // offsetof
+#include <stdio.h> // snprintf
 #include <stdlib.h> // malloc
 #include <string.h> // memset
 #include "compiler.h" // __visible
@@ -33,14 +34,13 @@ struct syncemitter {
     struct list_node ss_node;
     // Transmit message queue
     struct list_head msg_queue;
-    // Thread for step generation
+    // Storage for list of pending move clocks (if emitter has own queue)
+    uint64_t *move_clocks;
+    int num_move_clocks;
+    // Step generation (run from a steppersyncmgr worker thread)
     struct stepcompress *sc;
     struct stepper_kinematics *sk;
     char name[16];
-    pthread_t tid;
-    pthread_mutex_t lock; // protects variables below
-    pthread_cond_t cond;
-    int have_work;
     double bg_gen_steps_time;
     uint64_t bg_flush_clock, bg_clear_history_clock;
     int32_t bg_result;
@@ -78,12 +78,20 @@ syncemitter_queue_msg(struct syncemitter *se, uint64_t req_clock
     list_add_tail(&qm->node, &se->msg_queue);
 }
 
+// Note that the mcu stores this emitter's moves in a dedicated queue
+void __visible
+syncemitter_setup_movequeue(struct syncemitter *se, int move_num)
+{
+    free(se->move_clocks);
+    se->move_clocks = malloc(sizeof(*se->move_clocks)*move_num);
+    memset(se->move_clocks, 0, sizeof(*se->move_clocks)*move_num);
+    se->num_move_clocks = move_num;
+}
+
 // Generate steps (via itersolve) and flush
 static int32_t
 se_generate_steps(struct syncemitter *se)
 {
-    if (!se->sc || !se->sk)
-        return 0;
     double gen_steps_time = se->bg_gen_steps_time;
     uint64_t flush_clock = se->bg_flush_clock;
     uint64_t clear_history_clock = se->bg_clear_history_clock;
@@ -100,68 +108,7 @@ se_generate_steps(struct syncemitter *se)
     return 0;
 }
 
-// Main background thread for generating steps
-static void *
-se_background_thread(void *data)
-{
-    struct syncemitter *se = data;
-    set_thread_name(se->name);
-
-    pthread_mutex_lock(&se->lock);
-    for (;;) {
-        if (!se->have_work) {
-            pthread_cond_wait(&se->cond, &se->lock);
-            continue;
-        }
-        if (se->have_work < 0)
-            // Exit request
-            break;
-
-        // Request to generate steps
-        se->bg_result = se_generate_steps(se);
-        if (se->bg_result)
-            errorf("Error in syncemitter '%s' step generation", se->name);
-        se->have_work = 0;
-        pthread_cond_signal(&se->cond);
-    }
-    pthread_mutex_unlock(&se->lock);
-
-    return NULL;
-}
-
-// Signal background thread to start step generation
-static void
-se_start_gen_steps(struct syncemitter *se, double gen_steps_time
-                   , uint64_t flush_clock, uint64_t clear_history_clock)
-{
-    if (!se->sc || !se->sk)
-        return;
-    pthread_mutex_lock(&se->lock);
-    while (se->have_work)
-        pthread_cond_wait(&se->cond, &se->lock);
-    se->bg_gen_steps_time = gen_steps_time;
-    se->bg_flush_clock = flush_clock;
-    se->bg_clear_history_clock = clear_history_clock;
-    se->have_work = 1;
-    pthread_mutex_unlock(&se->lock);
-    pthread_cond_signal(&se->cond);
-}
-
-// Wait for background thread to complete last step generation request
-static int32_t
-se_finalize_gen_steps(struct syncemitter *se)
-{
-    if (!se->sc || !se->sk)
-        return 0;
-    pthread_mutex_lock(&se->lock);
-    while (se->have_work)
-        pthread_cond_wait(&se->cond, &se->lock);
-    int32_t res = se->bg_result;
-    pthread_mutex_unlock(&se->lock);
-    return res;
-}
-
-// Allocate syncemitter and start thread
+// Allocate syncemitter
 static struct syncemitter *
 syncemitter_alloc(char name[16], int alloc_stepcompress)
 {
@@ -170,43 +117,20 @@ syncemitter_alloc(char name[16], int alloc_stepcompress)
     list_init(&se->msg_queue);
     strncpy(se->name, name, sizeof(se->name));
     se->name[sizeof(se->name)-1] = '\0';
-    if (!alloc_stepcompress)
-        return se;
-    se->sc = stepcompress_alloc(&se->msg_queue);
-    int ret = pthread_mutex_init(&se->lock, NULL);
-    if (ret)
-        goto fail;
-    ret = pthread_cond_init(&se->cond, NULL);
-    if (ret)
-        goto fail;
-    ret = pthread_create(&se->tid, NULL, se_background_thread, se);
-    if (ret)
-        goto fail;
+    if (alloc_stepcompress)
+        se->sc = stepcompress_alloc(&se->msg_queue);
     return se;
-fail:
-    report_errno("se alloc", ret);
-    return NULL;
 }
 
-// Free syncemitter and exit background thread
+// Free syncemitter
 static void
 syncemitter_free(struct syncemitter *se)
 {
     if (!se)
         return;
-    if (se->sc) {
-        pthread_mutex_lock(&se->lock);
-        while (se->have_work)
-            pthread_cond_wait(&se->cond, &se->lock);
-        se->have_work = -1;
-        pthread_cond_signal(&se->cond);
-        pthread_mutex_unlock(&se->lock);
-        int ret = pthread_join(se->tid, NULL);
-        if (ret)
-            report_errno("se pthread_join", ret);
-        stepcompress_free(se->sc);
-    }
+    stepcompress_free(se->sc);
     message_queue_free(&se->msg_queue);
+    free(se->move_clocks);
     free(se);
 }
 
@@ -228,6 +152,9 @@ struct steppersync {
     // Storage for list of pending move clocks
     uint64_t *move_clocks;
     int num_move_clocks;
+    // Encoded msgids for merging queue_step commands into queue_steps
+    uint8_t step_prefix[8], steps_prefix[8];
+    int step_prefix_len, steps_prefix_len;
 };
 
 // Allocate a new syncemitter instance
@@ -257,6 +184,28 @@ steppersync_setup_movequeue(struct steppersync *ss, struct serialqueue *sq
     ss->num_move_clocks = move_num;
 }
 
+// Store the encoded form of a message id
+static int
+encode_msgtag(uint8_t *prefix, int msgtag)
+{
+    uint32_t data = msgtag;
+    struct queue_message *qm = message_alloc_and_encode(&data, 1);
+    int len = qm->len;
+    memcpy(prefix, qm->msg, len);
+    message_free(qm);
+    return len;
+}
+
+// Enable merging of queue_step commands into queue_steps commands
+void __visible
+steppersync_setup_batching(struct steppersync *ss, int queue_step_msgtag
+                           , int queue_steps_msgtag)
+{
+    ss->step_prefix_len = encode_msgtag(ss->step_prefix, queue_step_msgtag);
+    ss->steps_prefix_len = encode_msgtag(ss->steps_prefix
+                                         , queue_steps_msgtag);
+}
+
 // Set the conversion rate of 'print_time' to mcu clock
 void __visible
 steppersync_set_time(struct steppersync *ss, double time_offset
@@ -273,10 +222,9 @@ steppersync_set_time(struct steppersync *ss, double time_offset
 // Implement a binary heap algorithm to track when the next available
 // 'struct move' in the mcu will be available
 static void
-heap_replace(struct steppersync *ss, uint64_t req_clock)
+heap_replace(uint64_t *mc, int nmc, uint64_t req_clock)
 {
-    uint64_t *mc = ss->move_clocks;
-    int nmc = ss->num_move_clocks, pos = 0;
+    int pos = 0;
     for (;;) {
         int child1_pos = 2*pos+1, child2_pos = 2*pos+2;
         uint64_t child2_clock = child2_pos < nmc ? mc[child2_pos] : UINT64_MAX;
@@ -295,6 +243,55 @@ heap_replace(struct steppersync *ss, uint64_t req_clock)
     }
 }
 
+// Check if a message starts with the given encoded msgid
+static int
+check_prefix(struct queue_message *qm, uint8_t *prefix, int prefix_len)
+{
+    return qm->len > prefix_len && !memcmp(qm->msg, prefix, prefix_len);
+}
+
+// Don't merge a move if that would delay the preceding command to
+// within this amount of time of its requested clock
+#define BATCH_MIN_LEAD 0.100
+
+// Attempt to append a queue_step command to the preceding command
+static int
+steppersync_merge_step(struct steppersync *ss, struct list_head *msgs
+                       , struct queue_message *qm)
+{
+    int plen = ss->step_prefix_len, splen = ss->steps_prefix_len;
+    if (!splen || list_empty(msgs) || !check_prefix(qm, ss->step_prefix, plen))
+        return 0;
+    struct queue_message *prev = list_last_entry(
+        msgs, struct queue_message, node);
+    if (qm->min_clock > prev->min_clock) {
+        uint64_t lead = ss->ce.est_freq * BATCH_MIN_LEAD;
+        if (qm->min_clock + lead > prev->req_clock)
+            return 0;
+    }
+    // Parameters of a queue_step are stored in the queue_steps data
+    // buffer in their encoded form (without the queue_step msgid)
+    int add_len = qm->len - plen;
+    if (check_prefix(prev, ss->step_prefix, plen)) {
+        int data_len = prev->len - plen + add_len;
+        if (splen + 1 + data_len > MESSAGE_PAYLOAD_MAX)
+            return 0;
+        memmove(&prev->msg[splen + 1], &prev->msg[plen], prev->len - plen);
+        memcpy(prev->msg, ss->steps_prefix, splen);
+        prev->msg[splen] = 0;
+        prev->len = splen + 1 + prev->len - plen;
+    } else if (!check_prefix(prev, ss->steps_prefix, splen)
+               || prev->len + add_len > MESSAGE_PAYLOAD_MAX) {
+        return 0;
+    }
+    memcpy(&prev->msg[prev->len], &qm->msg[plen], add_len);
+    prev->len += add_len;
+    prev->msg[splen] = prev->len - splen - 1;
+    if (qm->min_clock > prev->min_clock)
+        prev->min_clock = qm->min_clock;
+    return 1;
+}
+
 // Find and transmit any scheduled steps prior to the given 'move_clock'
 static void
 steppersync_flush(struct steppersync *ss, uint64_t move_clock)
@@ -306,13 +303,14 @@ steppersync_flush(struct steppersync *ss, uint64_t move_clock)
         // Find message with lowest reqclock
         uint64_t req_clock = MAX_CLOCK;
         struct queue_message *qm = NULL;
-        struct syncemitter *se;
+        struct syncemitter *se, *qm_se = NULL;
         list_for_each_entry(se, &ss->se_list, ss_node) {
             if (!list_empty(&se->msg_queue)) {
                 struct queue_message *m = list_first_entry(
                     &se->msg_queue, struct queue_message, node);
                 if (m->req_clock < req_clock) {
                     qm = m;
+                    qm_se = se;
                     req_clock = m->req_clock;
                 }
             }
@@ -320,17 +318,28 @@ steppersync_flush(struct steppersync *ss, uint64_t move_clock)
         if (!qm || (qm->min_clock && req_clock > move_clock))
             break;
 
-        uint64_t next_avail = ss->move_clocks[0];
+        // Emitters may have a dedicated move queue in the mcu
+        uint64_t *mc = ss->move_clocks;
+        int nmc = ss->num_move_clocks;
+        if (qm_se->move_clocks) {
+            mc = qm_se->move_clocks;
+            nmc = qm_se->num_move_clocks;
+        }
+        uint64_t next_avail = mc[0];
         if (qm->min_clock)
             // The qm->min_clock field is overloaded to indicate that
             // the command uses the 'move queue' and to store the time
             // that move queue item becomes available.
-            heap_replace(ss, qm->min_clock);
+            heap_replace(mc, nmc, qm->min_clock);
         // Reset the min_clock to its normal meaning (minimum transmit time)
         qm->min_clock = next_avail;
 
         // Batch this command
         list_del(&qm->node);
+        if (steppersync_merge_step(ss, &msgs, qm)) {
+            message_free(qm);
+            continue;
+        }
         list_add_tail(&qm->node, &msgs);
     }
 
@@ -344,26 +353,136 @@ steppersync_flush(struct steppersync *ss, uint64_t move_clock)
  * StepperSyncMgr - manage a list of steppersync
  ****************************************************************/
 
+// The steppersyncmgr owns a fixed size pool of threads that generate
+// steps.  On each steppersyncmgr_gen_steps() call the syncemitters
+// with pending work are placed in a shared array and each thread
+// (including the caller) repeatedly claims the next unprocessed
+// emitter from that array until none remain.  This balances the work
+// across the available cores regardless of the number of steppers.
+
 struct steppersyncmgr {
     struct list_head ss_list;
+    // Step generation thread pool
+    pthread_t *tids;
+    int num_tids, next_thread_id;
+    pthread_mutex_t lock; // protects variables below
+    pthread_cond_t cond, done_cond;
+    uint32_t work_gen;
+    int pending_workers, exit_request;
+    // Storage for the current step generation work list
+    struct syncemitter **work;
+    int work_count, work_alloc, work_next;
 };
 
+// Claim and process emitters from the work list until it is empty
+static void
+ssm_process_work(struct steppersyncmgr *ssm, int work_count)
+{
+    for (;;) {
+        int pos = __atomic_fetch_add(&ssm->work_next, 1, __ATOMIC_RELAXED);
+        if (pos >= work_count)
+            break;
+        struct syncemitter *se = ssm->work[pos];
+        se->bg_result = se_generate_steps(se);
+        if (se->bg_result)
+            errorf("Error in syncemitter '%s' step generation", se->name);
+    }
+}
+
+// Main background thread for generating steps
+static void *
+ssm_background_thread(void *data)
+{
+    struct steppersyncmgr *ssm = data;
+    char name[16];
+    int thread_id = __atomic_fetch_add(&ssm->next_thread_id, 1
+                                       , __ATOMIC_RELAXED);
+    snprintf(name, sizeof(name), "stepgen%d", thread_id);
+    set_thread_name(name);
+
+    pthread_mutex_lock(&ssm->lock);
+    uint32_t last_gen = 0;
+    for (;;) {
+        if (ssm->exit_request)
+            break;
+        if (ssm->work_gen == last_gen) {
+            pthread_cond_wait(&ssm->cond, &ssm->lock);
+            continue;
+        }
+        // Request to generate steps
+        last_gen = ssm->work_gen;
+        int work_count = ssm->work_count;
+        pthread_mutex_unlock(&ssm->lock);
+
+        ssm_process_work(ssm, work_count);
+
+        pthread_mutex_lock(&ssm->lock);
+        if (!--ssm->pending_workers)
+            pthread_cond_signal(&ssm->done_cond);
+    }
+    pthread_mutex_unlock(&ssm->lock);
+
+    return NULL;
+}
+
 // Allocate a new 'steppersyncmgr' object
 struct steppersyncmgr * __visible
-steppersyncmgr_alloc(void)
+steppersyncmgr_alloc(int num_threads)
 {
     struct steppersyncmgr *ssm = malloc(sizeof(*ssm));
     memset(ssm, 0, sizeof(*ssm));
     list_init(&ssm->ss_list);
+    int ret = pthread_mutex_init(&ssm->lock, NULL);
+    if (ret)
+        goto fail;
+    ret = pthread_cond_init(&ssm->cond, NULL);
+    if (ret)
+        goto fail;
+    ret = pthread_cond_init(&ssm->done_cond, NULL);
+    if (ret)
+        goto fail;
+    // The calling thread also generates steps, so start one less thread
+    int count = num_threads > 1 ? num_threads - 1 : 0;
+    ssm->tids = malloc(sizeof(*ssm->tids) * (count ? count : 1));
+    int i;
+    for (i=0; i<count; i++) {
+        ret = pthread_create(&ssm->tids[i], NULL, ssm_background_thread, ssm);
+        if (ret) {
+            report_errno("ssm pthread_create", ret);
+            // Stop the threads that were started and release memory
+            steppersyncmgr_free(ssm);
+            return NULL;
+        }
+        ssm->num_tids++;
+    }
     return ssm;
+fail:
+    report_errno("ssm alloc", ret);
+    free(ssm);
+    return NULL;
 }
 
-// Free memory associated with a 'steppersync' object
+// Free memory associated with a 'steppersyncmgr' object
 void __visible
 steppersyncmgr_free(struct steppersyncmgr *ssm)
 {
     if (!ssm)
         return;
+    // Exit background threads
+    pthread_mutex_lock(&ssm->lock);
+    ssm->exit_request = 1;
+    int num_tids = ssm->num_tids;
+    pthread_cond_broadcast(&ssm->cond);
+    pthread_mutex_unlock(&ssm->lock);
+    int i;
+    for (i=0; i<num_tids; i++) {
+        int ret = pthread_join(ssm->tids[i], NULL);
+        if (ret)
+            report_errno("ssm pthread_join", ret);
+    }
+    free(ssm->tids);
+    free(ssm->work);
+    // Free steppersync objects
     while (!list_empty(&ssm->ss_list)) {
         struct steppersync *ss = list_first_entry(
             &ssm->ss_list, struct steppersync, ssm_node);
@@ -381,6 +500,13 @@ steppersyncmgr_free(struct steppersyncmgr *ssm)
     free(ssm);
 }
 
+// Return the number of threads that generate steps (including the caller)
+int __visible
+steppersyncmgr_get_thread_count(struct steppersyncmgr *ssm)
+{
+    return ssm->num_tids + 1;
+}
+
 // Allocate a new 'steppersync' object
 struct steppersync * __visible
 steppersyncmgr_alloc_steppersync(struct steppersyncmgr *ssm)
@@ -392,14 +518,30 @@ steppersyncmgr_alloc_steppersync(struct steppersyncmgr *ssm)
     return ss;
 }
 
+// Add a syncemitter to the list of pending step generation work
+static void
+ssm_add_work(struct steppersyncmgr *ssm, struct syncemitter *se)
+{
+    if (ssm->work_count >= ssm->work_alloc) {
+        int alloc = ssm->work_alloc ? ssm->work_alloc * 2 : 16;
+        ssm->work = realloc(ssm->work, sizeof(*ssm->work) * alloc);
+        ssm->work_alloc = alloc;
+    }
+    ssm->work[ssm->work_count++] = se;
+}
+
 // Generate and flush steps
 struct syncemitter * __visible
 steppersyncmgr_gen_steps(struct steppersyncmgr *ssm, double flush_time
                          , double gen_steps_time, double clear_history_time)
 {
     struct steppersync *ss;
-    // Prepare trapqs for step generation
+    // Prepare trapqs and work list for step generation
+    pthread_mutex_lock(&ssm->lock);
+    ssm->work_count = 0;
     list_for_each_entry(ss, &ssm->ss_list, ssm_node) {
+        uint64_t flush_clock = clock_from_time(&ss->ce, flush_time);
+        uint64_t clear_clock = clock_from_time(&ss->ce, clear_history_time);
         struct syncemitter *se;
         list_for_each_entry(se, &ss->se_list, ss_node) {
             if (!se->sc || !se->sk)
@@ -407,24 +549,36 @@ steppersyncmgr_gen_steps(struct steppersyncmgr *ssm, double flush_time
             struct trapq *tq = itersolve_get_trapq(se->sk);
             if (tq)
                 trapq_check_sentinels(tq);
+            se->bg_gen_steps_time = gen_steps_time;
+            se->bg_flush_clock = flush_clock;
+            se->bg_clear_history_clock = clear_clock;
+            se->bg_result = 0;
+            ssm_add_work(ssm, se);
         }
     }
     // Start step generation threads
-    list_for_each_entry(ss, &ssm->ss_list, ssm_node) {
-        uint64_t flush_clock = clock_from_time(&ss->ce, flush_time);
-        uint64_t clear_clock = clock_from_time(&ss->ce, clear_history_time);
-        struct syncemitter *se;
-        list_for_each_entry(se, &ss->se_list, ss_node) {
-            se_start_gen_steps(se, gen_steps_time, flush_clock, clear_clock);
-        }
+    int work_count = ssm->work_count;
+    ssm->work_next = 0;
+    if (work_count > 1 && ssm->num_tids) {
+        // Every thread must acknowledge the request before returning
+        ssm->pending_workers = ssm->num_tids;
+        ssm->work_gen++;
+        pthread_cond_broadcast(&ssm->cond);
     }
+    pthread_mutex_unlock(&ssm->lock);
+    // Generate steps from this thread as well
+    ssm_process_work(ssm, work_count);
     // Wait for step generation threads to complete
+    pthread_mutex_lock(&ssm->lock);
+    while (ssm->pending_workers)
+        pthread_cond_wait(&ssm->done_cond, &ssm->lock);
+    pthread_mutex_unlock(&ssm->lock);
+    // Transmit generated steps
     struct syncemitter *failed_se = NULL;
     list_for_each_entry(ss, &ssm->ss_list, ssm_node) {
         struct syncemitter *se;
         list_for_each_entry(se, &ss->se_list, ss_node) {
-            int32_t ret = se_finalize_gen_steps(se);
-            if (ret)
+            if (se->bg_result)
                 failed_se = se;
         }
         if (failed_se)
@@ -434,3 +588,34 @@ steppersyncmgr_gen_steps(struct steppersyncmgr *ssm, double flush_time
     }
     return failed_se;
 }
+
+
+/****************************************************************
+ * Benchmarking support
+ ****************************************************************/
+
+// Generate and compress the steps of a syncemitter without an mcu.
+// The resulting messages are discarded.  Returns the number of
+// messages generated (or a negative error code).
+int32_t __visible
+syncemitter_bench_gen_steps(struct syncemitter *se, double gen_steps_time
+                            , uint64_t flush_clock)
+{
+    struct trapq *tq = itersolve_get_trapq(se->sk);
+    if (tq)
+        trapq_check_sentinels(tq);
+    se->bg_gen_steps_time = gen_steps_time;
+    se->bg_flush_clock = se->bg_clear_history_clock = flush_clock;
+    int32_t ret = se_generate_steps(se);
+    if (ret)
+        return ret;
+    int32_t count = 0;
+    while (!list_empty(&se->msg_queue)) {
+        struct queue_message *qm = list_first_entry(
+            &se->msg_queue, struct queue_message, node);
+        list_del(&qm->node);
+        message_free(qm);
+        count++;
+    }
+    return count;
+}
@@ -11,17 +11,21 @@ struct stepper_kinematics *syncemitter_get_stepper_kinematics(
     struct syncemitter *se);
 void syncemitter_queue_msg(struct syncemitter *se, uint64_t req_clock
                            , uint32_t *data, int len);
+void syncemitter_setup_movequeue(struct syncemitter *se, int move_num);
 
 struct steppersync;
 struct syncemitter *steppersync_alloc_syncemitter(
     struct steppersync *ss, char name[16], int alloc_stepcompress);
 void steppersync_setup_movequeue(struct steppersync *ss, struct serialqueue *sq
                                  , int move_num);
+void steppersync_setup_batching(struct steppersync *ss, int queue_step_msgtag
+                                , int queue_steps_msgtag);
 void steppersync_set_time(struct steppersync *ss, double time_offset
                           , double mcu_freq);
 
-struct steppersyncmgr *steppersyncmgr_alloc(void);
+struct steppersyncmgr *steppersyncmgr_alloc(int num_threads);
 void steppersyncmgr_free(struct steppersyncmgr *ssm);
+int steppersyncmgr_get_thread_count(struct steppersyncmgr *ssm);
 struct serialqueue;
 struct steppersync *steppersyncmgr_alloc_steppersync(
     struct steppersyncmgr *ssm);
@@ -29,5 +33,8 @@ struct syncemitter *steppersyncmgr_gen_steps(struct steppersyncmgr *ssm
                                              , double flush_time
                                              , double gen_steps_time
                                              , double clear_history_time);
+int32_t syncemitter_bench_gen_steps(struct syncemitter *se
+                                    , double gen_steps_time
+                                    , uint64_t flush_clock);
 
 #endif // steppersync.h
@@ -11,15 +11,6 @@
 #include "compiler.h" // unlikely
 #include "trapq.h" // move_get_coord
 
-// Allocate a new 'move' object
-struct move *
-move_alloc(void)
-{
-    struct move *m = malloc(sizeof(*m));
-    memset(m, 0, sizeof(*m));
-    return m;
-}
-
 // Return the distance moved given a time in a move
 inline double
 move_get_distance(struct move *m, double move_time)
@@ -40,6 +31,44 @@ move_get_coord(struct move *m, double move_time)
 
 #define NEVER_TIME 9999999999999999.9
 
+// Moves are allocated in blocks ("slabs") that are owned by each
+// trapq.  Moves that are no longer needed are placed on a per-trapq
+// free list for reuse, which avoids a malloc/free pair for every move.
+#define MOVE_SLAB_SIZE 256
+
+struct move_slab {
+    struct list_node node;
+    struct move moves[MOVE_SLAB_SIZE];
+};
+
+// Allocate a new 'move' object
+struct move *
+trapq_move_alloc(struct trapq *tq)
+{
+    if (unlikely(list_empty(&tq->free_moves))) {
+        struct move_slab *ms = malloc(sizeof(*ms));
+        list_add_head(&ms->node, &tq->slabs);
+        int i;
+        for (i=0; i<MOVE_SLAB_SIZE; i++)
+            list_add_tail(&ms->moves[i].node, &tq->free_moves);
+        tq->alloc_moves += MOVE_SLAB_SIZE;
+    }
+    struct move *m = list_first_entry(&tq->free_moves, struct move, node);
+    list_del(&m->node);
+    memset(m, 0, sizeof(*m));
+    if (++tq->live_moves > tq->peak_moves)
+        tq->peak_moves = tq->live_moves;
+    return m;
+}
+
+// Release a 'move' object (it must not be on any list)
+void
+trapq_move_free(struct trapq *tq, struct move *m)
+{
+    list_add_head(&m->node, &tq->free_moves);
+    tq->live_moves--;
+}
+
 // Allocate a new 'trapq' object
 struct trapq * __visible
 trapq_alloc(void)
@@ -48,7 +77,10 @@ trapq_alloc(void)
     memset(tq, 0, sizeof(*tq));
     list_init(&tq->moves);
     list_init(&tq->history);
-    struct move *head_sentinel = move_alloc(), *tail_sentinel = move_alloc();
+    list_init(&tq->slabs);
+    list_init(&tq->free_moves);
+    struct move *head_sentinel = &tq->head_sentinel;
+    struct move *tail_sentinel = &tq->tail_sentinel;
     head_sentinel->print_time = -1.0;
     tail_sentinel->print_time = tail_sentinel->move_t = NEVER_TIME;
     list_add_head(&head_sentinel->node, &tq->moves);
@@ -60,15 +92,11 @@ trapq_alloc(void)
 void __visible
 trapq_free(struct trapq *tq)
 {
-    while (!list_empty(&tq->moves)) {
-        struct move *m = list_first_entry(&tq->moves, struct move, node);
-        list_del(&m->node);
-        free(m);
-    }
-    while (!list_empty(&tq->history)) {
-        struct move *m = list_first_entry(&tq->history, struct move, node);
-        list_del(&m->node);
-        free(m);
+    while (!list_empty(&tq->slabs)) {
+        struct move_slab *ms = list_first_entry(
+            &tq->slabs, struct move_slab, node);
+        list_del(&ms->node);
+        free(ms);
     }
     free(tq);
 }
@@ -102,7 +130,7 @@ trapq_add_move(struct trapq *tq, struct move *m)
     struct move *prev = list_prev_entry(tail_sentinel, node);
     if (prev->print_time + prev->move_t < m->print_time) {
         // Add a null move to fill time gap
-        struct move *null_move = move_alloc();
+        struct move *null_move = trapq_move_alloc(tq);
         null_move->start_pos = m->start_pos;
         if (prev->print_time <= 0. && m->print_time > MAX_NULL_MOVE)
             // Limit the first null move to improve numerical stability
@@ -127,7 +155,7 @@ trapq_append(struct trapq *tq, double print_time
     struct coord start_pos = { .x=start_pos_x, .y=start_pos_y, .z=start_pos_z };
     struct coord axes_r = { .x=axes_r_x, .y=axes_r_y, .z=axes_r_z };
     if (accel_t) {
-        struct move *m = move_alloc();
+        struct move *m = trapq_move_alloc(tq);
         m->print_time = print_time;
         m->move_t = accel_t;
         m->start_v = start_v;
@@ -140,7 +168,7 @@ trapq_append(struct trapq *tq, double print_time
         start_pos = move_get_coord(m, accel_t);
     }
     if (cruise_t) {
-        struct move *m = move_alloc();
+        struct move *m = trapq_move_alloc(tq);
         m->print_time = print_time;
         m->move_t = cruise_t;
         m->start_v = cruise_v;
@@ -153,7 +181,7 @@ trapq_append(struct trapq *tq, double print_time
         start_pos = move_get_coord(m, cruise_t);
     }
     if (decel_t) {
-        struct move *m = move_alloc();
+        struct move *m = trapq_move_alloc(tq);
         m->print_time = print_time;
         m->move_t = decel_t;
         m->start_v = cruise_v;
@@ -164,6 +192,31 @@ trapq_append(struct trapq *tq, double print_time
     }
 }
 
+// Parameters of a move in a trapq_append_batch() request (the fields
+// match the parameters of trapq_append())
+struct trapq_append_move {
+    double print_time, accel_t, cruise_t, decel_t;
+    double start_pos_x, start_pos_y, start_pos_z;
+    double axes_r_x, axes_r_y, axes_r_z;
+    double start_v, cruise_v, accel;
+};
+
+// Add 'count' moves to the queue.  The 'data' array contains the packed
+// parameters of each move (as described by struct trapq_append_move).
+void __visible
+trapq_append_batch(struct trapq *tq, double *data, int count)
+{
+    struct trapq_append_move *moves = (void*)data;
+    int i;
+    for (i=0; i<count; i++) {
+        struct trapq_append_move *m = &moves[i];
+        trapq_append(tq, m->print_time, m->accel_t, m->cruise_t, m->decel_t
+                     , m->start_pos_x, m->start_pos_y, m->start_pos_z
+                     , m->axes_r_x, m->axes_r_y, m->axes_r_z
+                     , m->start_v, m->cruise_v, m->accel);
+    }
+}
+
 // Expire any moves older than `print_time` from the trapezoid velocity queue
 void __visible
 trapq_finalize_moves(struct trapq *tq, double print_time
@@ -184,7 +237,7 @@ trapq_finalize_moves(struct trapq *tq, double print_time
         if (m->start_v || m->half_accel)
             list_add_head(&m->node, &tq->history);
         else
-            free(m);
+            trapq_move_free(tq, m);
     }
     // Free old moves from history list
     if (list_empty(&tq->history))
@@ -195,7 +248,7 @@ trapq_finalize_moves(struct trapq *tq, double print_time
         if (m == latest || m->print_time + m->move_t > clear_history_time)
             break;
         list_del(&m->node);
-        free(m);
+        trapq_move_free(tq, m);
     }
 }
 
@@ -216,11 +269,11 @@ trapq_set_position(struct trapq *tq, double print_time
             break;
         }
         list_del(&m->node);
-        free(m);
+        trapq_move_free(tq, m);
     }
 
     // Add a marker to the trapq history
-    struct move *m = move_alloc();
+    struct move *m = trapq_move_alloc(tq);
     m->print_time = print_time;
     m->start_pos.x = pos_x;
     m->start_pos.y = pos_y;
@@ -271,3 +324,12 @@ trapq_extract_old(struct trapq *tq, struct pull_move *p, int max
     }
     return res;
 }
+
+// Report move allocation statistics
+void __visible
+trapq_get_stats(struct trapq *tq, struct trapq_stats *s)
+{
+    s->live_moves = tq->live_moves;
+    s->peak_moves = tq->peak_moves;
+    s->alloc_moves = tq->alloc_moves;
+}
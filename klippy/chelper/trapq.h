@@ -22,6 +22,14 @@ struct move {
 
 struct trapq {
     struct list_head moves, history;
+    // Move storage
+    struct list_head slabs, free_moves;
+    struct move head_sentinel, tail_sentinel;
+    int live_moves, peak_moves, alloc_moves;
+};
+
+struct trapq_stats {
+    int live_moves, peak_moves, alloc_moves;
 };
 
 struct pull_move {
@@ -31,11 +39,12 @@ struct pull_move {
     double x_r, y_r, z_r;
 };
 
-struct move *move_alloc(void);
 double move_get_distance(struct move *m, double move_time);
 struct coord move_get_coord(struct move *m, double move_time);
 struct trapq *trapq_alloc(void);
 void trapq_free(struct trapq *tq);
+struct move *trapq_move_alloc(struct trapq *tq);
+void trapq_move_free(struct trapq *tq, struct move *m);
 void trapq_check_sentinels(struct trapq *tq);
 void trapq_add_move(struct trapq *tq, struct move *m);
 void trapq_append(struct trapq *tq, double print_time
@@ -43,11 +52,13 @@ void trapq_append(struct trapq *tq, double print_time
                   , double start_pos_x, double start_pos_y, double start_pos_z
                   , double axes_r_x, double axes_r_y, double axes_r_z
                   , double start_v, double cruise_v, double accel);
+void trapq_append_batch(struct trapq *tq, double *data, int count);
 void trapq_finalize_moves(struct trapq *tq, double print_time
                           , double clear_history_time);
 void trapq_set_position(struct trapq *tq, double print_time
                         , double pos_x, double pos_y, double pos_z);
 int trapq_extract_old(struct trapq *tq, struct pull_move *p, int max
                       , double start_time, double end_time);
+void trapq_get_stats(struct trapq *tq, struct trapq_stats *s);
 
 #endif // trapq.h
@@ -4,6 +4,7 @@
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
 import logging, threading, struct
+import chelper
 
 # This "bulk sensor" module facilitates the processing of sensor chip
 # measurements that do not require the host to respond with low
@@ -113,6 +114,7 @@ class BatchWebhooksClient:
         return True
 
 SENSOR_BULK_FMT = "sensor_bulk_data oid=%c sequence=%hu data=%*s"
+PULL_COUNT = 64
 
 # Helper class to store incoming messages in a queue
 class BulkDataQueue:
@@ -120,12 +122,55 @@ class BulkDataQueue:
         # Measurement storage (accessed from background thread)
         self.lock = threading.Lock()
         self.raw_samples = []
+        self.c_queue = None
+        if msg_fmt == SENSOR_BULK_FMT and oid is not None:
+            # Messages are stored by the C code (bypassing python parsing)
+            self.c_queue = mcu.register_bulk_queue(msg_fmt, oid)
+            self.pull_data = self.pull_view = None
+            self._alloc_pull_data(PULL_COUNT)
+            return
         # Register callback with mcu
         mcu.register_serial_response(self._handle_data, msg_fmt, oid)
     def _handle_data(self, params):
         with self.lock:
             self.raw_samples.append(params)
+    def _alloc_pull_data(self, count):
+        ffi_main, ffi_lib = chelper.get_ffi()
+        pull_data = ffi_main.new("struct pull_bulk_data[%d]" % (count,))
+        if self.pull_data is not None:
+            ffi_main.memmove(pull_data, self.pull_data,
+                             ffi_main.sizeof(self.pull_data))
+        self.pull_data = pull_data
+        self.pull_view = memoryview(ffi_main.buffer(pull_data))
+        self.pull_count = count
+        self.pull_entry_size = ffi_main.sizeof("struct pull_bulk_data")
+        self.pull_data_offset = ffi_main.offsetof("struct pull_bulk_data",
+                                                  "data")
+    def _pull_c_queue(self):
+        # Copy all pending messages from the C queue
+        count = 0
+        while 1:
+            avail = self.pull_count - count
+            ret = self.c_queue.pull(self.pull_data + count, avail)
+            count += ret
+            if ret < avail:
+                break
+            self._alloc_pull_data(self.pull_count * 2)
+        # Note, 'data' is a view into pull_data (valid until next pull)
+        pull_data = self.pull_data
+        pull_view = self.pull_view
+        entry_size = self.pull_entry_size
+        offset = self.pull_data_offset
+        raw_samples = [None] * count
+        for i in range(count):
+            entry = pull_data[i]
+            start = i * entry_size + offset
+            raw_samples[i] = {'sequence': entry.sequence,
+                              'data': pull_view[start:start + entry.len]}
+        return raw_samples
     def pull_queue(self):
+        if self.c_queue is not None:
+            return self._pull_c_queue()
         with self.lock:
             raw_samples = self.raw_samples
             self.raw_samples = []
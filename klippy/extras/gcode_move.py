@@ -5,6 +5,11 @@
 # This file may be distributed under the terms of the GNU GPLv3 license.
 import logging
 
+# Parameter mask bits and value indexes used by the gcode fast path
+FAST_INDEX_F = ord('F') - ord('A')
+FAST_PARAM_F = 1 << FAST_INDEX_F
+FAST_PARAMS_XYZE = sum([1 << (ord(a) - ord('A')) for a in 'XYZE'])
+
 class GCodeMove:
     def __init__(self, config):
         self.printer = printer = config.get_printer()
@@ -21,6 +26,9 @@ class GCodeMove:
             desc = getattr(self, 'cmd_' + cmd + '_help', None)
             gcode.register_command(cmd, func, False, desc)
         gcode.register_command('G0', self.cmd_G1)
+        for cmd in ['G0', 'G1']:
+            gcode.register_fast_handler(cmd, self.fast_G1)
+        gcode.register_fast_handler('G92', self.fast_G92)
         gcode.register_command('M114', self.cmd_M114, True)
         gcode.register_command('GET_POSITION', self.cmd_GET_POSITION, True,
                                desc=self.cmd_GET_POSITION_help)
@@ -31,6 +39,7 @@ class GCodeMove:
         self.last_position = [0.0, 0.0, 0.0, 0.0]
         self.homing_position = [0.0, 0.0, 0.0, 0.0]
         self.axis_map = {'X':0, 'Y': 1, 'Z': 2, 'E': 3}
+        self._build_fast_axes()
         self.speed = 25.
         self.speed_factor = 1. / 60.
         self.extrude_factor = 1.
@@ -128,8 +137,15 @@ class GCodeMove:
                 continue
             axis_map[gcode_id] = index
         self.axis_map = axis_map
+        self._build_fast_axes()
         self.base_position[4:] = [0.] * (len(extra_axes) - 4)
         self.reset_last_position()
+    def _build_fast_axes(self):
+        # Parameter mask bit, value index, and position of each axis
+        self.fast_axes = []
+        for axis, pos in self.axis_map.items():
+            idx = ord(axis) - ord('A')
+            self.fast_axes.append((1 << idx, idx, pos, axis == 'E'))
     # G-Code movement commands
     def cmd_G1(self, gcmd):
         # Move
@@ -159,6 +175,28 @@ class GCodeMove:
             raise gcmd.error("Unable to parse move '%s'"
                              % (gcmd.get_commandline(),))
         self.move_with_transform(self.last_position, self.speed)
+    def fast_G1(self, mask, values):
+        # Move (with parameters pre-parsed by the gcode fast path)
+        if mask & FAST_PARAM_F:
+            gcode_speed = values[FAST_INDEX_F]
+            if gcode_speed <= 0.:
+                # Report error via cmd_G1()
+                return False
+            self.speed = gcode_speed * self.speed_factor
+        for bit, idx, pos, is_extrude in self.fast_axes:
+            if mask & bit:
+                v = values[idx]
+                absolute_coord = self.absolute_coord
+                if is_extrude:
+                    v *= self.extrude_factor
+                    if not self.absolute_extrude:
+                        absolute_coord = False
+                if not absolute_coord:
+                    self.last_position[pos] += v
+                else:
+                    self.last_position[pos] = v + self.base_position[pos]
+        self.move_with_transform(self.last_position, self.speed)
+        return True
     # G-Code coordinate manipulation
     def cmd_G20(self, gcmd):
         # Set units to inches
@@ -188,6 +226,19 @@ class GCodeMove:
                 self.base_position[i] = self.last_position[i] - offset
         if offsets == [None, None, None, None]:
             self.base_position[:4] = self.last_position[:4]
+    def fast_G92(self, mask, values):
+        # Set position (with parameters pre-parsed by the gcode fast path)
+        if not mask & FAST_PARAMS_XYZE:
+            self.base_position[:4] = self.last_position[:4]
+            return True
+        for i, axis in enumerate('XYZE'):
+            idx = ord(axis) - ord('A')
+            if mask & (1 << idx):
+                offset = values[idx]
+                if i == 3:
+                    offset *= self.extrude_factor
+                self.base_position[i] = self.last_position[i] - offset
+        return True
     def cmd_M114(self, gcmd):
         # Get Current Position
         p = self._get_gcode_position()
@@ -3,7 +3,7 @@
 # Copyright (C) 2025  Kevin O'Connor <kevin@koconnor.net>
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
-import logging
+import logging, multiprocessing
 import chelper
 
 BGFLUSH_LOW_TIME = 0.200
@@ -28,13 +28,25 @@ class PrinterMotionQueuing:
         self.trapqs = []
         ffi_main, ffi_lib = chelper.get_ffi()
         self.trapq_finalize_moves = ffi_lib.trapq_finalize_moves
+        self.trapq_stats = ffi_main.new('struct trapq_stats *')
         # C steppersync tracking
-        self.steppersyncmgr = ffi_main.gc(ffi_lib.steppersyncmgr_alloc(),
-                                          ffi_lib.steppersyncmgr_free)
+        pconfig = config.getsection('printer')
+        num_threads = pconfig.getint('step_generation_threads',
+                                     multiprocessing.cpu_count(), minval=1)
+        self.steppersyncmgr = ffi_main.gc(
+            ffi_lib.steppersyncmgr_alloc(num_threads),
+            ffi_lib.steppersyncmgr_free)
+        if self.steppersyncmgr == ffi_main.NULL:
+            raise config.error("Unable to start step generation threads")
+        self.step_gen_threads = ffi_lib.steppersyncmgr_get_thread_count(
+            self.steppersyncmgr)
         self.syncemitters = []
         self.syncemitter_to_name = {}
         self.steppersyncs = []
         self.steppersyncmgr_gen_steps = ffi_lib.steppersyncmgr_gen_steps
+        self.step_compress_lookahead = pconfig.getint(
+            'step_compress_lookahead', 0, minval=0, maxval=256)
+        self.stepcompress_stats = ffi_main.new('struct stepcompress_stats *')
         # History expiration
         self.clear_history_time = 0.
         # Flush notification callbacks
@@ -65,12 +77,39 @@ class PrinterMotionQueuing:
         trapq = ffi_main.gc(ffi_lib.trapq_alloc(), ffi_lib.trapq_free)
         self.trapqs.append(trapq)
         return trapq
+    def get_status(self, eventtime):
+        ffi_main, ffi_lib = chelper.get_ffi()
+        stats = self.trapq_stats
+        live_moves = peak_moves = alloc_moves = 0
+        for trapq in self.trapqs:
+            ffi_lib.trapq_get_stats(trapq, stats)
+            live_moves += stats.live_moves
+            peak_moves += stats.peak_moves
+            alloc_moves += stats.alloc_moves
+        sc_stats = self.stepcompress_stats
+        step_count = queue_step_count = 0
+        for se in self.syncemitters:
+            sc = ffi_lib.syncemitter_get_stepcompress(se)
+            if sc == ffi_main.NULL:
+                continue
+            ffi_lib.stepcompress_get_stats(sc, sc_stats)
+            step_count += sc_stats.step_count
+            queue_step_count += sc_stats.queue_step_count
+        return {'trapq_live_moves': live_moves,
+                'trapq_peak_moves': peak_moves,
+                'trapq_alloc_moves': alloc_moves,
+                'step_generation_threads': self.step_gen_threads,
+                'step_count': step_count,
+                'queue_step_count': queue_step_count}
     def wipe_trapq(self, trapq):
         # Expire any remaining movement in the trapq (force to history list)
         self.trapq_finalize_moves(trapq, self.reactor.NEVER, 0.)
     def lookup_trapq_append(self):
         ffi_main, ffi_lib = chelper.get_ffi()
         return ffi_lib.trapq_append
+    def lookup_trapq_append_batch(self):
+        ffi_main, ffi_lib = chelper.get_ffi()
+        return ffi_lib.trapq_append_batch
     # C steppersync tracking
     def _lookup_steppersync(self, mcu):
         for ss_mcu, ss in self.steppersyncs:
@@ -89,12 +128,28 @@ class PrinterMotionQueuing:
                                                    alloc_stepcompress)
         self.syncemitter_to_name[se] = name
         self.syncemitters.append(se)
+        if alloc_stepcompress:
+            sc = ffi_lib.syncemitter_get_stepcompress(se)
+            ffi_lib.stepcompress_set_lookahead(sc, self.step_compress_lookahead)
         return se
     def setup_mcu_movequeue(self, mcu, serialqueue, move_count):
         # Setup steppersync object for the mcu's main movequeue
         ffi_main, ffi_lib = chelper.get_ffi()
         ss = self._lookup_steppersync(mcu)
         ffi_lib.steppersync_setup_movequeue(ss, serialqueue, move_count)
+        # Merge queue_step commands into queue_steps (if mcu supports it)
+        step_cmd = mcu.try_lookup_command(
+            "queue_step oid=%c interval=%u count=%hu add=%hi")
+        steps_cmd = mcu.try_lookup_command("queue_steps data=%*s")
+        delta_cmd = mcu.try_lookup_command(
+            "queue_step_delta oid=%c interval=%i count=%hu add=%hi")
+        if delta_cmd is not None:
+            # Steppers send queue_step_delta commands instead
+            step_cmd = delta_cmd
+            steps_cmd = mcu.try_lookup_command("queue_steps_delta data=%*s")
+        if step_cmd is not None and steps_cmd is not None:
+            ffi_lib.steppersync_setup_batching(
+                ss, step_cmd.get_command_tag(), steps_cmd.get_command_tag())
         mcu_freq = float(mcu.seconds_to_clock(1.))
         ffi_lib.steppersync_set_time(ss, 0., mcu_freq)
     def stats(self, eventtime):
@@ -107,7 +162,24 @@ class PrinterMotionQueuing:
         # Calculate history expiration
         est_print_time = self.mcu.estimated_print_time(eventtime)
         self.clear_history_time = max(0., est_print_time - MOVE_HISTORY_EXPIRE)
-        return False, ""
+        if not self.step_compress_lookahead:
+            return False, ""
+        # Report step compression ratio (steps per queue_step command)
+        stats = self.stepcompress_stats
+        ratios = []
+        for se in self.syncemitters:
+            sc = ffi_lib.syncemitter_get_stepcompress(se)
+            if sc == ffi_main.NULL:
+                continue
+            ffi_lib.stepcompress_get_stats(sc, stats)
+            if not stats.queue_step_count:
+                continue
+            name = self.syncemitter_to_name[se].split()[-1]
+            ratios.append("%s=%.2f" % (
+                name, float(stats.step_count) / stats.queue_step_count))
+        if not ratios:
+            return False, ""
+        return False, "stepcompress: " + " ".join(ratios)
     # Flush notification callbacks
     def register_flush_callback(self, callback, can_add_trapq=False):
         if can_add_trapq:
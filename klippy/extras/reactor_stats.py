@@ -0,0 +1,53 @@
+# Report per-callback latency statistics of the host reactor
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import logging
+
+REPORT_COUNT = 5
+
+class ReactorStats:
+    def __init__(self, config):
+        self.printer = config.get_printer()
+        self.reactor = self.printer.get_reactor()
+        self.report_threshold = config.getfloat('report_threshold', 0.050,
+                                                minval=0.)
+        self.reactor.enable_callback_stats()
+        self.printer.register_event_handler("klippy:analyze_shutdown",
+                                            self._handle_analyze_shutdown)
+        webhooks = self.printer.lookup_object('webhooks')
+        webhooks.register_endpoint("reactor/callback_stats",
+                                   self._handle_stats_request)
+    def _slowest(self, key):
+        cb_stats = self.reactor.get_callback_stats().values()
+        return sorted(cb_stats, key=key, reverse=True)[:REPORT_COUNT]
+    def _handle_analyze_shutdown(self, msg, details):
+        out = ["%s: run max=%.6f p99=%.6f late max=%.6f count=%d"
+               % (cs.name, cs.run_time.max, cs.run_time.percentile(.99),
+                  cs.lateness.max, cs.run_time.count)
+               for cs in self._slowest(lambda cs: cs.run_time.max)]
+        logging.info("Reactor slowest callbacks:\n%s", "\n".join(out))
+    def _get_callback_stats(self):
+        cb_stats = self.reactor.get_callback_stats()
+        return {name: cs.get_status() for name, cs in cb_stats.items()}
+    def _handle_stats_request(self, web_request):
+        web_request.send(self._get_callback_stats())
+    def get_status(self, eventtime):
+        return {'callbacks': self._get_callback_stats()}
+    def stats(self, eventtime):
+        # Report the slowest callback since the last stats report
+        cb_stats = self.reactor.get_callback_stats().values()
+        if not cb_stats:
+            return (False, '')
+        worst = max(cb_stats, key=(lambda cs: cs.interval_max))
+        max_run = worst.interval_max
+        for cs in cb_stats:
+            cs.interval_max = 0.
+        if max_run < self.report_threshold:
+            return (False, 'reactor_max_run=%.6f' % (max_run,))
+        return (False, 'reactor_max_run=%.6f reactor_slowest=%s'
+                % (max_run, worst.name))
+
+def load_config(config):
+    return ReactorStats(config)
@@ -4,6 +4,7 @@
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
 import os, time, logging
+import chelper
 
 class PrinterSysStats:
     def __init__(self, config):
@@ -12,6 +13,10 @@ class PrinterSysStats:
         self.last_load_avg = 0.
         self.last_mem_avail = 0
         self.mem_file = None
+        ffi_main, ffi_lib = chelper.get_ffi()
+        self.msg_alloc = ffi_main.new('uint32_t *')
+        self.msg_pool = ffi_main.new('uint32_t *')
+        self.message_get_stats = ffi_lib.message_get_stats
         try:
             self.mem_file = open("/proc/meminfo", "r")
         except:
@@ -43,6 +48,10 @@ class PrinterSysStats:
                         break
             except:
                 pass
+        # Get host message allocation stats (shared by all mcus)
+        self.message_get_stats(self.msg_alloc, self.msg_pool)
+        msg = "%s msg_alloc=%d msg_pool=%d" % (msg, self.msg_alloc[0],
+                                                self.msg_pool[0])
         return (False, msg)
     def get_status(self, eventtime):
         return {'sysload': self.last_load_avg,
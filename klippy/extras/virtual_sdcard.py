@@ -3,9 +3,19 @@
 # Copyright (C) 2018-2024  Kevin O'Connor <kevin@koconnor.net>
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
-import os, sys, logging, io
+import os, logging, bisect
+import chelper
 
-VALID_GCODE_EXTS = ['gcode', 'g', 'gco']
+# Pre-parsed g-code files (see scripts/preparse_gcode.py)
+PREPARSED_EXT = 'kgc'
+PREPARSED_HEADER = b"KLGC\x01\x00\x00\x00"
+
+VALID_GCODE_EXTS = ['gcode', 'g', 'gco', PREPARSED_EXT]
+
+# Number of bytes read from the file at a time (and the readahead size)
+READ_SIZE = 65536
+# Maximum number of pre-parsed records decoded at a time
+MAX_RECORDS = 2048
 
 DEFAULT_ERROR_GCODE = """
 {% if 'heaters' in printer %}
@@ -13,6 +23,152 @@ DEFAULT_ERROR_GCODE = """
 {% endif %}
 """
 
+# Read blocks of complete lines from a g-code file
+class GCodeFileReader:
+    def __init__(self, executor, filename):
+        self.executor = executor
+        self.name = filename
+        self.fd = executor.submit(os.open, filename, os.O_RDONLY)
+        try:
+            self.size = executor.submit(os.fstat, self.fd).st_size
+        except:
+            os.close(self.fd)
+            raise
+        self._advise(0, 0, 'POSIX_FADV_SEQUENTIAL')
+        # Lines of the most recently read block and the file offset of
+        # each line (along with the offset after the last line)
+        self.lines = []
+        self.offsets = [0]
+        self.tokens = None
+    def _advise(self, pos, count, advice):
+        if hasattr(os, 'posix_fadvise'):
+            os.posix_fadvise(self.fd, pos, count, getattr(os, advice))
+    def close(self):
+        os.close(self.fd)
+    def _pread(self, count, pos):
+        # Read from the file at pos (runs in the executor thread)
+        os.lseek(self.fd, pos, os.SEEK_SET)
+        return os.read(self.fd, count)
+    def _read_block(self, pos):
+        # Read complete lines starting at pos (runs in the executor thread)
+        data = b""
+        while 1:
+            chunk = self._pread(READ_SIZE, pos + len(data))
+            data += chunk
+            end = data.rfind(b'\n') + 1
+            if end or not chunk:
+                break
+        # Request readahead of the next block
+        self._advise(pos + end, READ_SIZE, 'POSIX_FADV_WILLNEED')
+        return data[:end]
+    def find_lines(self, pos):
+        # Return the index in self.lines of the line starting at file
+        # position pos (reading a new block if needed) or None on EOF
+        offsets = self.offsets
+        if offsets[0] <= pos < offsets[-1]:
+            index = bisect.bisect_left(offsets, pos)
+            if offsets[index] == pos:
+                return index
+        data = self.executor.submit(self._read_block, pos)
+        if not data:
+            return None
+        blines = data.split(b'\n')
+        blines.pop()
+        text = data.decode()
+        if len(text) == len(data):
+            lines = text.split('\n')
+            lines.pop()
+        else:
+            lines = [l.decode() for l in blines]
+        self.lines = lines
+        offsets = [pos]
+        for l in blines:
+            pos += len(l) + 1
+            offsets.append(pos)
+        self.offsets = offsets
+        return 0
+    def read_data(self, pos, count):
+        return self.executor.submit(self._pread, count, pos)
+    def check_position(self, pos):
+        # A g-code file may be resumed from any position
+        pass
+
+# Read blocks of records from a pre-parsed g-code file
+class PreparsedFileReader(GCodeFileReader):
+    def __init__(self, executor, filename):
+        GCodeFileReader.__init__(self, executor, filename)
+        try:
+            header = self.read_data(0, len(PREPARSED_HEADER))
+        except:
+            self.close()
+            raise
+        if header != PREPARSED_HEADER:
+            self.close()
+            raise ValueError("Invalid pre-parsed g-code file header")
+        ffi_main, ffi_lib = chelper.get_ffi()
+        self._ffi_main = ffi_main
+        self._c_decode = ffi_lib.gcodeparse_decode
+        self._c_offsets = ffi_main.new('int[]', MAX_RECORDS + 1)
+        self.tokens = ffi_main.new('struct gcodeparse_line[]', MAX_RECORDS)
+        self.offsets = [len(PREPARSED_HEADER)]
+        # File positions known to be at the start of a record
+        self.record_starts = [len(PREPARSED_HEADER)]
+    def _read_block(self, pos):
+        # Read the data at pos (runs in the executor thread)
+        data = self._pread(READ_SIZE, pos)
+        self._advise(pos + len(data), READ_SIZE, 'POSIX_FADV_WILLNEED')
+        return data
+    def _decode_records(self, pos):
+        # Decode the records starting at a known record start position
+        data = self.executor.submit(self._read_block, pos)
+        tokens, c_offsets = self.tokens, self._c_offsets
+        count = self._c_decode(data, len(data), tokens, MAX_RECORDS,
+                               c_offsets)
+        if count < 0 or (not count and data):
+            raise ValueError("Invalid pre-parsed g-code file data")
+        if not count:
+            return False
+        # Only text records need a line (tokenized commands use self.tokens)
+        lines = [None] * count
+        for i in range(count):
+            if not tokens[i].code:
+                lines[i] = data[c_offsets[i] + 6:c_offsets[i + 1]].decode()
+        self.lines = lines
+        self.offsets = [pos + o
+                        for o in self._ffi_main.unpack(c_offsets, count + 1)]
+        record_starts = self.record_starts
+        for rpos in [pos, self.offsets[-1]]:
+            index = bisect.bisect_left(record_starts, rpos)
+            if index >= len(record_starts) or record_starts[index] != rpos:
+                record_starts.insert(index, rpos)
+        return True
+    def find_lines(self, pos):
+        # Records can only be decoded from their start, so a position
+        # (eg, from M26) must be a known record start.  Otherwise scan
+        # forward from the closest known record start to verify it.
+        pos = max(pos, len(PREPARSED_HEADER))
+        record_starts = self.record_starts
+        start = record_starts[bisect.bisect_right(record_starts, pos) - 1]
+        offsets = self.offsets
+        if not offsets[0] <= pos < offsets[-1]:
+            offsets = None
+        while 1:
+            if offsets is None:
+                if not self._decode_records(start):
+                    return None
+                offsets = self.offsets
+            if pos < offsets[-1]:
+                index = bisect.bisect_left(offsets, pos)
+                if offsets[index] != pos:
+                    raise ValueError("Position %d is not the start of a"
+                                     " pre-parsed g-code record" % (pos,))
+                return index
+            start = offsets[-1]
+            offsets = None
+    def check_position(self, pos):
+        # Raises ValueError if pos is not the start of a record
+        self.find_lines(pos)
+
 class VirtualSD:
     def __init__(self, config):
         self.printer = config.get_printer()
@@ -28,6 +184,10 @@ class VirtualSD:
         self.must_pause_work = self.cmd_from_sd = False
         self.next_file_position = 0
         self.work_timer = None
+        # Lines of the current batch
+        self.batch_lines = []
+        self.batch_offsets = [0]
+        self.line_end = 0
         # Error handling
         gcode_macro = self.printer.load_object(config, 'gcode_macro')
         aio = self.printer.load_object(config, 'aio_executor')
@@ -60,8 +220,7 @@ class VirtualSD:
             try:
                 readpos = max(file_position - 1024, 0)
                 readcount = file_position - readpos
-                current_file.seek(readpos)
-                data = current_file.read(readcount + 128)
+                data = current_file.read_data(readpos, readcount + 128)
             except:
                 logging.exception("virtual_sdcard shutdown read")
                 return
@@ -195,13 +354,11 @@ class VirtualSD:
             if fname not in flist:
                 fname = files_by_lower[fname.lower()]
             fname = os.path.join(self.sdcard_dirname, fname)
-            f = self.executor.submit(io.open, fname, 'rb', buffering=0)
-            f = self.executor.wrap_obj(f)
-            f = io.BufferedReader(f)
-            f.seek(0, os.SEEK_END)
-            fsize = f.tell()
-            f.seek(0)
-            f = io.TextIOWrapper(f, newline='')
+            if fname.lower().endswith('.' + PREPARSED_EXT):
+                f = PreparsedFileReader(self.executor, fname)
+            else:
+                f = GCodeFileReader(self.executor, fname)
+            fsize = f.size
         except:
             logging.exception("virtual_sdcard file open")
             raise gcmd.error("Unable to open file")
@@ -211,8 +368,18 @@ class VirtualSD:
         self.file_position = 0
         self.file_size = fsize
         self.print_stats.set_current_file(filename)
+    def _check_file_position(self, gcmd, pos):
+        if self.current_file is None:
+            return
+        try:
+            self.current_file.check_position(pos)
+        except ValueError as e:
+            raise gcmd.error(str(e))
     def cmd_M24(self, gcmd):
         # Start/resume SD print
+        if self.work_timer is not None:
+            raise gcmd.error("SD busy")
+        self._check_file_position(gcmd, self.file_position)
         self.do_resume()
     def cmd_M25(self, gcmd):
         # Pause SD print
@@ -222,6 +389,7 @@ class VirtualSD:
         if self.work_timer is not None:
             raise gcmd.error("SD busy")
         pos = gcmd.get_int('S', minval=0)
+        self._check_file_position(gcmd, pos)
         self.file_position = pos
     def cmd_M27(self, gcmd):
         # Report SD print status
@@ -237,55 +405,60 @@ class VirtualSD:
     def is_cmd_from_sd(self):
         return self.cmd_from_sd
     # Background work timer
+    def _check_next_line(self, count):
+        # Invoked by the gcode dispatcher before each line of the batch
+        if count:
+            # Previous line completed
+            self.file_position = self.next_file_position
+            if self.next_file_position != self.line_end:
+                # Position changed (via set_file_position())
+                return False
+        if (count >= len(self.batch_lines) or self.must_pause_work
+            or self.gcode.get_mutex().has_waiters()):
+            return False
+        self.line_end = self.batch_offsets[count + 1]
+        self.next_file_position = self.line_end
+        return True
     def work_handler(self, eventtime):
         logging.info("Starting SD card print (position %d)", self.file_position)
         self.reactor.unregister_timer(self.work_timer)
-        try:
-            self.current_file.seek(self.file_position)
-        except:
-            logging.exception("virtual_sdcard seek")
-            self.work_timer = None
-            return self.reactor.NEVER
         self.print_stats.note_start()
         gcode_mutex = self.gcode.get_mutex()
-        partial_input = ""
-        lines = []
         error_message = None
         while not self.must_pause_work:
-            if not lines:
-                # Read more data
-                try:
-                    data = self.current_file.read(8192)
-                except:
-                    logging.exception("virtual_sdcard read")
-                    break
-                if not data:
-                    # End of file
-                    self.current_file.close()
-                    self.current_file = None
-                    logging.info("Finished SD card print")
-                    self.gcode.respond_raw("Done printing file")
-                    break
-                lines = data.split('\n')
-                lines[0] = partial_input + lines[0]
-                partial_input = lines.pop()
-                lines.reverse()
-                self.reactor.pause(self.reactor.NOW)
-                continue
             # Pause if any other request is pending in the gcode class
             if gcode_mutex.test():
                 self.reactor.pause(self.reactor.monotonic() + 0.050)
                 continue
-            # Dispatch command
+            # Find the lines at the current position (reading if needed)
+            current_file = self.current_file
+            try:
+                index = current_file.find_lines(self.file_position)
+            except ValueError as e:
+                # Position not valid (eg, not a pre-parsed record start)
+                error_message = str(e)
+                self.gcode.respond_raw("!! %s" % (error_message,))
+                break
+            except:
+                logging.exception("virtual_sdcard read")
+                break
+            if index is None:
+                # End of file
+                current_file.close()
+                self.current_file = None
+                logging.info("Finished SD card print")
+                self.gcode.respond_raw("Done printing file")
+                break
+            self.batch_lines = current_file.lines[index:]
+            self.batch_offsets = current_file.offsets[index:]
+            tokens = current_file.tokens
+            if tokens is not None:
+                tokens = tokens + index
+            # Dispatch commands
             self.cmd_from_sd = True
-            line = lines.pop()
-            if sys.version_info.major >= 3:
-                next_file_position = self.file_position + len(line.encode()) + 1
-            else:
-                next_file_position = self.file_position + len(line) + 1
-            self.next_file_position = next_file_position
             try:
-                self.gcode.run_script(line)
+                self.gcode.run_script_lines(self.batch_lines,
+                                            self._check_next_line, tokens)
             except self.gcode.error as e:
                 error_message = str(e)
                 try:
@@ -297,20 +470,10 @@ class VirtualSD:
                 logging.exception("virtual_sdcard dispatch")
                 break
             self.cmd_from_sd = False
-            self.file_position = self.next_file_position
-            # Do we need to skip around?
-            if self.next_file_position != next_file_position:
-                try:
-                    self.current_file.seek(self.file_position)
-                except:
-                    logging.exception("virtual_sdcard seek")
-                    self.work_timer = None
-                    return self.reactor.NEVER
-                lines = []
-                partial_input = ""
         logging.info("Exiting SD card print (position %d)", self.file_position)
         self.work_timer = None
         self.cmd_from_sd = False
+        self.batch_lines = []
         if error_message is not None:
             self.print_stats.note_error(error_message)
         elif self.current_file is not None:
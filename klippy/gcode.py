@@ -3,11 +3,15 @@
 # Copyright (C) 2016-2025  Kevin O'Connor <kevin@koconnor.net>
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
-import os, re, logging, collections, shlex, operator
+import os, re, logging, collections, shlex, operator, decimal
+import chelper
 
 class CommandError(Exception):
     pass
 
+# Maximum number of lines passed to the C tokenizer in a single call
+FAST_PARSE_LINES = 64
+
 # Custom "tuple" class for coordinates - add easy access to x, y, z components
 class Coord(tuple):
     __slots__ = ()
@@ -115,6 +119,11 @@ class GCodeDispatch:
         self.mux_commands = {}
         self.gcode_help = {}
         self.status_commands = {}
+        # Handlers of simple commands that accept pre-parsed parameters
+        self.fast_handlers = {}
+        ffi_main, ffi_lib = chelper.get_ffi()
+        self._ffi_main = ffi_main
+        self._c_parse_lines = ffi_lib.gcodeparse_lines
         # Register commands needed before config file is loaded
         handlers = ['M110', 'M112', 'M115',
                     'RESTART', 'FIRMWARE_RESTART', 'ECHO', 'STATUS', 'HELP']
@@ -155,6 +164,20 @@ class GCodeDispatch:
         if desc is not None:
             self.gcode_help[cmd] = desc
         self._build_status_commands()
+    def register_fast_handler(self, cmd, fast_func):
+        # The fast_func(mask, values) callback is invoked with numeric
+        # parameters already parsed - parameter letter 'X' is present if
+        # bit (1 << (ord('X') - ord('A'))) is set in mask and its value is
+        # in values[ord('X') - ord('A')].  The callback may return False
+        # to have the command processed by the regular handler instead.
+        func = self.ready_gcode_handlers.get(cmd)
+        num = cmd[1:]
+        if (func is None or not self.is_traditional_gcode(cmd)
+            or not num.isdigit() or len(num) > 4 or num != str(int(num))):
+            raise self.printer.config_error(
+                "Can't register fast handler for '%s'" % (cmd,))
+        code = (ord(cmd[0]) << 16) | int(num)
+        self.fast_handlers[code] = (cmd, func, fast_func)
     def register_mux_command(self, cmd, key, value, func, desc=None):
         prev = self.mux_commands.get(cmd)
         if prev is None:
@@ -199,28 +222,78 @@ class GCodeDispatch:
         self._respond_state("Ready")
     # Parse input into commands
     args_r = re.compile('([A-Z_]+|[A-Z*])')
-    def _process_commands(self, commands, need_ack=True):
-        for line in commands:
-            # Ignore comments and leading/trailing spaces
-            line = origline = line.strip()
-            cpos = line.find(';')
-            if cpos >= 0:
-                line = line[:cpos]
-            # Break line into parts and determine command
-            parts = self.args_r.split(line.upper())
-            if ''.join(parts[:2]) == 'N':
-                # Skip line number at start of command
-                cmd = ''.join(parts[3:5]).strip()
-            else:
-                cmd = ''.join(parts[:3]).strip()
-            # Build gcode "params" dictionary
-            params = { parts[i]: parts[i+1].strip()
-                       for i in range(1, len(parts), 2) }
-            gcmd = GCodeCommand(self, cmd, origline, params, need_ack)
+    def _parse_command(self, line, need_ack):
+        # Ignore comments and leading/trailing spaces
+        line = origline = line.strip()
+        cpos = line.find(';')
+        if cpos >= 0:
+            line = line[:cpos]
+        # Break line into parts and determine command
+        parts = self.args_r.split(line.upper())
+        if ''.join(parts[:2]) == 'N':
+            # Skip line number at start of command
+            cmd = ''.join(parts[3:5]).strip()
+        else:
+            cmd = ''.join(parts[:3]).strip()
+        # Build gcode "params" dictionary
+        params = { parts[i]: parts[i+1].strip()
+                   for i in range(1, len(parts), 2) }
+        return GCodeCommand(self, cmd, origline, params, need_ack)
+    def _tokenize_lines(self, lines):
+        # Tokenize lines in C so simple commands can skip the parsing above
+        data = '\n'.join(lines).encode('utf-8', 'replace')
+        tokens = self._ffi_main.new('struct gcodeparse_line[]', len(lines))
+        self._c_parse_lines(data, len(data), tokens, len(lines))
+        return tokens
+    def _format_tokens(self, token):
+        # Recreate the text of a line from its tokens
+        code, mask = token.code, token.param_mask
+        parts = ["%s%d" % (chr(code >> 16), code & 0xffff)]
+        for i in range(26):
+            if mask & (1 << i):
+                value = repr(token.values[i])
+                if 'e' in value:
+                    value = format(decimal.Decimal(value), 'f')
+                parts.append("%s%s" % (chr(ord('A') + i), value))
+        return " ".join(parts)
+    def _process_commands(self, commands, need_ack=True, check_line=None,
+                          tokens=None):
+        # If pre-parsed tokens are provided then the text of a command
+        # may be None (the text is then recreated only if needed)
+        fast_handlers = self.fast_handlers
+        for i, line in enumerate(commands):
+            if check_line is not None and not check_line(i):
+                return
+            # Check for a command that can use the fast path
+            fast_func = None
+            if tokens is not None:
+                token = tokens[i]
+            elif fast_handlers:
+                pos = i % FAST_PARSE_LINES
+                if not pos:
+                    parsed = self._tokenize_lines(
+                        commands[i:i+FAST_PARSE_LINES])
+                token = parsed[pos]
+            if fast_handlers:
+                fh = fast_handlers.get(token.code)
+                if fh is not None and self.gcode_handlers.get(fh[0]) is fh[1]:
+                    cmd, handler, fast_func = fh
+            gcmd = None
+            if fast_func is None:
+                if line is None:
+                    line = self._format_tokens(token)
+                gcmd = self._parse_command(line, need_ack)
+                cmd = gcmd.get_command()
+                handler = self.gcode_handlers.get(cmd, self.cmd_default)
             # Invoke handler for command
-            handler = self.gcode_handlers.get(cmd, self.cmd_default)
             try:
-                handler(gcmd)
+                if gcmd is None and not fast_func(token.param_mask,
+                                                  token.values):
+                    if line is None:
+                        line = self._format_tokens(token)
+                    gcmd = self._parse_command(line, need_ack)
+                if gcmd is not None:
+                    handler(gcmd)
             except self.error as e:
                 self._respond_error(str(e))
                 self.printer.send_event("gcode:command_error")
@@ -233,12 +306,24 @@ class GCodeDispatch:
                 self._respond_error(msg)
                 if not need_ack:
                     raise
-            gcmd.ack()
+            if gcmd is not None:
+                gcmd.ack()
+            elif need_ack:
+                self.respond_raw("ok")
+        if check_line is not None:
+            check_line(len(commands))
     def run_script_from_command(self, script):
         self._process_commands(script.split('\n'), need_ack=False)
     def run_script(self, script):
         with self.mutex:
             self._process_commands(script.split('\n'), need_ack=False)
+    def run_script_lines(self, lines, check_line, tokens=None):
+        # Run a batch of lines - check_line(count) is invoked with the
+        # number of lines completed before each line (and after the
+        # last line) and may return False to stop processing the batch
+        with self.mutex:
+            self._process_commands(lines, need_ack=False,
+                                   check_line=check_line, tokens=tokens)
     def get_mutex(self):
         return self.mutex
     def create_gcode_command(self, command, commandline, params):
@@ -147,6 +147,34 @@ class AsyncResponseWrapper:
     def unregister(self):
         self._serial.register_response(None, self._name, self._oid)
 
+# Wrapper for bulk sensor messages (stored in a queue by background thread)
+class BulkQueueWrapper:
+    def __init__(self, conn_helper, cfg_helper, msgformat, oid):
+        self._serial = conn_helper.get_serial()
+        self._msgformat = msgformat
+        self._oid = oid
+        ffi_main, self._ffi_lib = chelper.get_ffi()
+        self._bulkqueue = ffi_main.gc(self._ffi_lib.bulkqueue_alloc(),
+                                      self._ffi_lib.bulkqueue_free)
+        if cfg_helper.is_config_finalized():
+            self._register()
+        else:
+            cfg_helper.register_post_init_callback(self._register)
+    def _register(self):
+        msgtag = self._serial.get_msgparser().lookup_msgid(self._msgformat)
+        sq = self._serial.get_serialqueue()
+        self._ffi_lib.bulkqueue_setup(self._bulkqueue, sq,
+                                      msgtag & 0xffffffff, self._oid)
+        # Freeing the bulkqueue removes it from the serialqueue - so
+        # the serialqueue must not be freed before the bulkqueue
+        ffi_main, ffi_lib = chelper.get_ffi()
+        ffi_main.gc(self._bulkqueue, None)
+        self._bulkqueue = ffi_main.gc(
+            self._bulkqueue, (lambda bq, sq=sq: ffi_lib.bulkqueue_free(bq)))
+    def pull(self, pull_data, max_count):
+        return self._ffi_lib.bulkqueue_pull(self._bulkqueue, pull_data,
+                                            max_count)
+
 
 ######################################################################
 # Wrapper classes for MCU pins
@@ -269,6 +297,8 @@ class MCU_trsync:
         self._response_trsync = None
         self._trigger_completion = None
         if self._mcu.is_fileoutput():
+            for s in self._steppers:
+                s.note_homing_end()
             return self.REASON_ENDSTOP_HIT
         params = self._trsync_query_cmd.send([self._oid,
                                               self.REASON_HOST_REQUEST])
@@ -774,7 +804,11 @@ class MCUConnectHelper:
         self._reactor = printer.get_reactor()
         self._name = name = mcu.get_name()
         # Serial port
-        self._serial = serialhdl.SerialReader(self._reactor, mcu_name=name)
+        shared_io = config.getboolean('shared_io_thread', False)
+        adaptive_window = config.getboolean('adaptive_send_window', False)
+        self._serial = serialhdl.SerialReader(
+            self._reactor, mcu_name=name, shared_io_thread=shared_io,
+            adaptive_send_window=adaptive_window)
         self._baud = 0
         self._canbus_iface = None
         canbus_uuid = config.get('canbus_uuid', None)
@@ -1204,6 +1238,9 @@ class MCU:
     def register_serial_response(self, cb, msg, oid=None):
         return AsyncResponseWrapper(self._conn_helper, self._config_helper,
                                     cb, msg, oid)
+    def register_bulk_queue(self, msg, oid):
+        return BulkQueueWrapper(self._conn_helper, self._config_helper,
+                                msg, oid)
     def check_valid_response(self, msgformat):
         try:
             self._serial.get_msgparser().lookup_command(msgformat)
@@ -39,6 +39,7 @@ class PT_uint32:
     is_dynamic_string = False
     max_length = 5
     signed = False
+    c_type = 'u'
     def encode(self, out, v):
         if v >= 0xc000000 or v < -0x4000000: out.append((v>>28) & 0x7f | 0x80)
         if v >= 0x180000 or v < -0x80000:    out.append((v>>21) & 0x7f | 0x80)
@@ -61,6 +62,7 @@ class PT_uint32:
 
 class PT_int32(PT_uint32):
     signed = True
+    c_type = 'i'
 class PT_uint16(PT_uint32):
     max_length = 3
 class PT_int16(PT_int32):
@@ -73,12 +75,15 @@ class PT_string:
     is_int = False
     is_dynamic_string = True
     max_length = 64
+    c_type = 's'
     def encode(self, out, v):
         out.append(len(v))
         out.extend(bytearray(v))
     def parse(self, s, pos):
         l = s[pos]
         return bytes(bytearray(s[pos+1:pos+l+1])), pos+l+1
+    def c_convert(self, v, msg, ffi_main):
+        return ffi_main.buffer(msg + (v & 0xff), v >> 8)[:]
 class PT_progmem_buffer(PT_string):
     pass
 class PT_buffer(PT_string):
@@ -99,6 +104,7 @@ class Enumeration:
     def __init__(self, pt, enum_name, enums):
         self.pt = pt
         self.max_length = pt.max_length
+        self.c_type = pt.c_type
         self.enum_name = enum_name
         self.enums = enums
         self.reverse_enums = {v: k for k, v in enums.items()}
@@ -113,6 +119,11 @@ class Enumeration:
         if tv is None:
             tv = "?%d" % (v,)
         return tv, pos
+    def c_convert(self, v, msg, ffi_main):
+        tv = self.reverse_enums.get(v)
+        if tv is None:
+            tv = "?%d" % (v,)
+        return tv
 
 MessageTypes = {
     '%u': PT_uint32(), '%i': PT_int32(),
@@ -168,6 +179,12 @@ class MessageFormat:
         self.param_names = lookup_params(msgformat, enumerations)
         self.param_types = [t for name, t in self.param_names]
         self.name_to_type = dict(self.param_names)
+        # Parameter information for the C message parser
+        self.c_param_types = ''.join([t.c_type for t in self.param_types])
+        self.c_param_names = [name for name, t in self.param_names]
+        self.c_param_count = len(self.c_param_names)
+        self.c_convert_params = [(name, t) for name, t in self.param_names
+                                 if not t.is_int]
     def encode(self, params):
         out = list(self.msgid_bytes)
         for i, t in enumerate(self.param_types):
@@ -237,6 +254,7 @@ class MessageParser:
         self.config = {}
         self.version = self.build_versions = ""
         self.raw_identify_data = ""
+        self.c_parser = None
         self._init_messages(DefaultMessages)
     def _error(self, msg, *params):
         raise error(self.warn_prefix + (msg % params))
@@ -289,6 +307,38 @@ class MessageParser:
             self._error("Extra data at end of message")
         params['#name'] = mid.name
         return params
+    def setup_c_parser(self, ffi_main, ffi_lib):
+        # Register message formats with the C message parser
+        c_parser = ffi_main.gc(ffi_lib.msgparse_alloc(), ffi_lib.msgparse_free)
+        for msgid, mid in self.messages_by_id.items():
+            if isinstance(mid, MessageFormat):
+                ffi_lib.msgparse_add_format(c_parser, msgid,
+                                            mid.c_param_types.encode())
+        self.c_values = ffi_main.new('int64_t[%d]' % (MESSAGE_PAYLOAD_MAX+1,))
+        self.ffi_main = ffi_main
+        self.ffi_lib = ffi_lib
+        self.c_parser = c_parser
+    def parse_c(self, msg, msglen, pos):
+        # Parse the message at 'pos' of a cffi buffer (or return None)
+        c_values = self.c_values
+        next_pos = self.ffi_lib.msgparse_parse(self.c_parser, msg, msglen, pos,
+                                               c_values)
+        if next_pos < 0:
+            return None, pos
+        mid = self.messages_by_id[c_values[0]]
+        params = dict(zip(mid.c_param_names, self.ffi_main.unpack(
+            c_values + 1, mid.c_param_count)))
+        for name, t in mid.c_convert_params:
+            params[name] = t.c_convert(params[name], msg, self.ffi_main)
+        params['#name'] = mid.name
+        return params, next_pos
+    def parse_cdata(self, msg, msglen):
+        # Parse a message stored in a cffi buffer (not thread safe)
+        if self.c_parser is not None:
+            params, pos = self.parse_c(msg, msglen, MESSAGE_HEADER_SIZE)
+            if pos == msglen - MESSAGE_TRAILER_SIZE:
+                return params
+        return self.parse(msg[0:msglen])
     def encode_msgblock(self, seq, cmd):
         msglen = MESSAGE_MIN + len(cmd)
         seq = (seq & MESSAGE_SEQ_MASK) | MESSAGE_DEST
@@ -3,7 +3,7 @@
 # Copyright (C) 2016-2026  Kevin O'Connor <kevin@koconnor.net>
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
-import os, select, math, time, logging, queue
+import os, select, math, time, logging, queue, heapq
 import greenlet
 import chelper, util
 
@@ -18,6 +18,8 @@ class ReactorTimer:
         self.callback = self.underlying_callback = callback
         self.waketime = waketime
         self.timer_is_running = False
+        self.timer_id = -1
+        self.heap_key = None
 
 class ReactorCompletion:
     class sentinel: pass
@@ -64,6 +66,66 @@ class ReactorGreenlet(greenlet.greenlet):
     def __init__(self, run):
         greenlet.greenlet.__init__(self, run=run)
         self.timer = None
+        self.pause_count = 0
+        self.pause_time = 0.
+
+# Histogram with logarithmically sized buckets (bucket 'i' holds values
+# from HIST_BASE*2**(i-1) to HIST_BASE*2**i)
+HIST_BASE = 0.000010
+HIST_BUCKETS = 20
+
+class ReactorHistogram:
+    def __init__(self):
+        self.buckets = [0] * HIST_BUCKETS
+        self.count = 0
+        self.total = self.max = 0.
+    def add(self, value):
+        b = math.frexp(value * (1. / HIST_BASE))[1]
+        self.buckets[max(0, min(b, HIST_BUCKETS - 1))] += 1
+        self.count += 1
+        self.total += value
+        if value > self.max:
+            self.max = value
+    def percentile(self, pct):
+        count = 0
+        for i, c in enumerate(self.buckets):
+            count += c
+            if count >= self.count * pct:
+                return min(HIST_BASE * 2.**i, self.max)
+        return self.max
+    def get_status(self):
+        return {'count': self.count, 'total': self.total, 'max': self.max,
+                'p50': self.percentile(.50), 'p90': self.percentile(.90),
+                'p99': self.percentile(.99), 'buckets': list(self.buckets)}
+
+# Determine the name used to report statistics for a callback
+def callback_name(cb):
+    name = getattr(cb, '__qualname__', None)
+    if name is not None:
+        return name
+    # Python 2 does not provide __qualname__
+    name = getattr(cb, '__name__', type(cb).__name__)
+    obj = getattr(cb, '__self__', None)
+    if obj is None:
+        return name
+    return "%s.%s" % (obj.__class__.__name__, name)
+
+class ReactorCallbackStats:
+    def __init__(self, name):
+        self.name = name
+        self.run_time = ReactorHistogram()
+        self.lateness = ReactorHistogram()
+        self.switch_count = 0
+        self.interval_max = 0.
+    def note_run(self, run_time, switches):
+        self.run_time.add(run_time)
+        self.switch_count += switches
+        if run_time > self.interval_max:
+            self.interval_max = run_time
+    def get_status(self):
+        return {'run_time': self.run_time.get_status(),
+                'lateness': self.lateness.get_status(),
+                'greenlet_switches': self.switch_count}
 
 class ReactorMutex:
     def __init__(self, reactor, is_locked):
@@ -75,6 +137,8 @@ class ReactorMutex:
         self.unlock = self.__exit__
     def test(self):
         return self.is_locked
+    def has_waiters(self):
+        return not not self.queue
     def __enter__(self):
         if not self.is_locked:
             self.is_locked = True
@@ -110,8 +174,13 @@ class SelectReactor:
         self._process = False
         self.monotonic = chelper.get_ffi()[1].get_monotonic
         # Timers
-        self._timers = []
+        self._timer_count = self._last_timer_id = 0
+        self._timer_heap = []
+        self._heap_push_count = 0
         self._next_timer = self.NEVER
+        # Due timers not yet dispatched
+        self._timer_batch = []
+        self._timer_batch_pos = 0
         # Idle notifier callback
         self._start_busy_time = 0.
         self._idle_callback = (lambda e, sbt: False)
@@ -136,49 +205,130 @@ class SelectReactor:
         self._latency_callback = (lambda e, pe, rc: None)
         self._recent_eventtime = 0.
         self._recent_callbacks = []
+        # Per callback latency statistics
+        self._cb_stats = None
     # Timers
     def update_timer(self, timer_handler, waketime):
         if timer_handler.timer_is_running:
             return
         timer_handler.waketime = waketime
+        if timer_handler.timer_id < 0:
+            return
+        if waketime >= self.NEVER:
+            timer_handler.heap_key = None
+            return
+        # Add to heap (any previous heap entry for the timer becomes stale)
+        self._heap_push_count = key = self._heap_push_count + 1
+        timer_handler.heap_key = key
+        heap = self._timer_heap
+        heapq.heappush(heap, (waketime, key, timer_handler))
+        if len(heap) > 2 * self._timer_count + 64:
+            self._compact_timer_heap()
         self._next_timer = min(self._next_timer, waketime)
     def register_timer(self, callback, waketime=NEVER):
         timer_handler = ReactorTimer(callback, waketime)
-        timers = list(self._timers)
-        timers.append(timer_handler)
-        self._timers = timers
-        self._next_timer = min(self._next_timer, waketime)
+        self._last_timer_id = timer_handler.timer_id = self._last_timer_id + 1
+        self._timer_count += 1
+        self.update_timer(timer_handler, waketime)
         return timer_handler
     def unregister_timer(self, timer_handler):
         timer_handler.waketime = self.NEVER
-        timers = list(self._timers)
-        timers.pop(timers.index(timer_handler))
-        self._timers = timers
-    def _check_timers(self, eventtime):
-        self._next_timer = self.NEVER
+        if timer_handler.timer_id < 0:
+            return
+        timer_handler.timer_id = -1
+        timer_handler.heap_key = None
+        self._timer_count -= 1
+    def _compact_timer_heap(self):
+        heap = [e for e in self._timer_heap if e[1] == e[2].heap_key]
+        heapq.heapify(heap)
+        self._timer_heap = heap
+    def _pop_due_timers(self, eventtime):
+        heap = self._timer_heap
+        due = []
+        while heap and eventtime >= heap[0][0]:
+            waketime, key, t = heapq.heappop(heap)
+            if key == t.heap_key:
+                t.heap_key = None
+                due.append(t)
+        self._next_timer = heap[0][0] if heap else self.NEVER
+        # Run timers in the order they were registered
+        if len(due) > 1:
+            due.sort(key=(lambda t: t.timer_id))
+        return due
+    def _requeue_timer_batch(self):
+        # Reschedule due timers that will not be run by this dispatch loop
+        batch = self._timer_batch
+        for i in range(self._timer_batch_pos, len(batch)):
+            t = batch[i]
+            self.update_timer(t, t.waketime)
+        self._timer_batch = []
+        self._timer_batch_pos = 0
+    def _run_timer_batch(self, eventtime):
         g_dispatch = self._g_dispatch
-        for t in self._timers:
+        batch = self._timer_batch
+        while self._timer_batch_pos < len(batch):
+            t = batch[self._timer_batch_pos]
+            self._timer_batch_pos += 1
             waketime = t.waketime
-            if eventtime >= waketime:
-                t.waketime = self.NEVER
-                t.timer_is_running = True
-                self._recent_callbacks.append(t.underlying_callback)
-                t.waketime = waketime = t.callback(eventtime)
-                t.timer_is_running = False
-                if g_dispatch is not self._g_dispatch:
-                    self._next_timer = min(self._next_timer, waketime)
-                    self._end_greenlet(g_dispatch)
-                    return
-            self._next_timer = min(self._next_timer, waketime)
+            if eventtime < waketime:
+                # Timer was rescheduled or removed by an earlier callback
+                continue
+            t.waketime = self.NEVER
+            t.timer_is_running = True
+            self._recent_callbacks.append(t.underlying_callback)
+            if self._cb_stats is None:
+                waketime = t.callback(eventtime)
+            else:
+                waketime = self._run_with_stats(
+                    t.underlying_callback, t.callback, eventtime, waketime)
+            t.timer_is_running = False
+            self.update_timer(t, waketime)
+            if g_dispatch is not self._g_dispatch:
+                self._end_greenlet(g_dispatch)
+                return
+    def _check_timers(self, eventtime):
+        self._timer_batch = self._pop_due_timers(eventtime)
+        self._timer_batch_pos = 0
+        self._run_timer_batch(eventtime)
+    # Latency statistics
+    def enable_callback_stats(self):
+        if self._cb_stats is None:
+            self._cb_stats = {}
+    def get_callback_stats(self):
+        if self._cb_stats is None:
+            return {}
+        return dict(self._cb_stats)
+    def _run_with_stats(self, stats_cb, callback, eventtime, waketime=None):
+        # Statistics are grouped by the callback's name (eg, class.method)
+        name = callback_name(stats_cb)
+        cs = self._cb_stats.get(name)
+        if cs is None:
+            cs = self._cb_stats[name] = ReactorCallbackStats(name)
+        g = self._g_dispatch
+        pause_count, pause_time = g.pause_count, g.pause_time
+        start_time = self.monotonic()
+        if waketime:
+            cs.lateness.add(max(0., start_time - waketime))
+        res = callback(eventtime)
+        run_time = self.monotonic() - start_time - (g.pause_time - pause_time)
+        cs.note_run(max(0., run_time), g.pause_count - pause_count)
+        return res
     # Idle notifiers
     def set_idle_notifier(self, callback):
         self._idle_callback = callback
-    def _calc_sleep_time(self, eventtime):
+    def _check_idle(self, eventtime):
         self._recent_callbacks.append(self._idle_callback)
         self._prevent_pause_count += 1
-        busy = self._idle_callback(eventtime, self._start_busy_time)
+        idle_cb, sbt = self._idle_callback, self._start_busy_time
+        if self._cb_stats is None:
+            busy = idle_cb(eventtime, sbt)
+        else:
+            busy = self._run_with_stats(idle_cb, (lambda e: idle_cb(e, sbt)),
+                                        eventtime)
         self._prevent_pause_count -= 1
-        if busy:
+        return busy
+    def _calc_sleep_time(self, eventtime):
+        if self._check_idle(eventtime):
             return 0.
         return min(1., max(.001, self._next_timer - eventtime))
     # Callbacks and Completions
@@ -232,7 +382,14 @@ class SelectReactor:
             self.verify_can_pause()
         # Determine if this greenlet is the main dispatch greenlet
         g = greenlet.getcurrent()
-        if g is not self._g_dispatch:
+        if self._cb_stats is not None:
+            return self._pause_with_stats(g, waketime)
+        return self._pause(g, waketime)
+    def _pause(self, g, waketime):
+        if g is self._g_dispatch:
+            # Other dispatch loops must be able to run any pending timers
+            self._requeue_timer_batch()
+        else:
             # This greenlet has called pause() before and has a timer setup,
             # so switch to _check_timers (via g.timer.callback return)
             return self._g_dispatch.switch(waketime)
@@ -250,6 +407,13 @@ class SelectReactor:
             eventtime = g.parent.switch()
         # This greenlet activated from g.timer.callback (via _check_timers)
         return eventtime
+    def _pause_with_stats(self, g, waketime):
+        # Track time this greenlet is paused (excluded from callback run time)
+        start_time = self.monotonic()
+        eventtime = self._pause(g, waketime)
+        g.pause_count += 1
+        g.pause_time += self.monotonic() - start_time
+        return eventtime
     def _end_greenlet(self, g_old):
         # A timer/io event that called pause() has completed.
         # Cleanup the internal timer associated with this greenlet.
@@ -301,13 +465,21 @@ class SelectReactor:
             hdl = self._fds.get(fd, self._dummy_fd_hdl)
             if event & self._READ:
                 self._recent_callbacks.append(hdl.read_callback)
-                hdl.read_callback(eventtime)
+                if self._cb_stats is None:
+                    hdl.read_callback(eventtime)
+                else:
+                    self._run_with_stats(hdl.read_callback, hdl.read_callback,
+                                         eventtime)
                 if g_dispatch is not self._g_dispatch:
                     self._end_greenlet(g_dispatch)
                     return True
             if event & self._WRITE:
                 self._recent_callbacks.append(hdl.write_callback)
-                hdl.write_callback(eventtime)
+                if self._cb_stats is None:
+                    hdl.write_callback(eventtime)
+                else:
+                    self._run_with_stats(hdl.write_callback,
+                                         hdl.write_callback, eventtime)
                 if g_dispatch is not self._g_dispatch:
                     self._end_greenlet(g_dispatch)
                     return True
@@ -439,6 +611,93 @@ class EPollReactor(SelectReactor):
     def _check_fd_activity(self, timeout):
         return self._epoll.poll(timeout)
 
+# Reactor with the timer schedule and fd polling implemented in C
+class CReactor(SelectReactor):
+    def __init__(self):
+        SelectReactor.__init__(self)
+        ffi_main, ffi_lib = chelper.get_ffi()
+        self._creactor = ffi_main.gc(ffi_lib.reactor_alloc(),
+                                     ffi_lib.reactor_free)
+        self._poll_result = ffi_main.new('struct reactor_poll_result *')
+        self._c_add_timer = ffi_lib.reactor_add_timer
+        self._c_update_timer = ffi_lib.reactor_update_timer
+        self._c_remove_timer = ffi_lib.reactor_remove_timer
+        self._c_set_fd = ffi_lib.reactor_set_fd
+        self._c_poll = ffi_lib.reactor_poll
+        self._timer_ids = {}
+    # Timers
+    def update_timer(self, timer_handler, waketime):
+        if timer_handler.timer_is_running:
+            return
+        timer_handler.waketime = waketime
+        self._c_update_timer(self._creactor, timer_handler.timer_id, waketime)
+    def register_timer(self, callback, waketime=_NEVER):
+        timer_handler = ReactorTimer(callback, waketime)
+        timer_id = self._c_add_timer(self._creactor, waketime)
+        timer_handler.timer_id = timer_id
+        self._timer_ids[timer_id] = timer_handler
+        return timer_handler
+    def unregister_timer(self, timer_handler):
+        timer_handler.waketime = self.NEVER
+        timer_id = timer_handler.timer_id
+        if timer_id < 0:
+            return
+        self._c_remove_timer(self._creactor, timer_id)
+        del self._timer_ids[timer_id]
+        timer_handler.timer_id = -1
+    # File descriptors
+    def register_fd(self, fd, read_callback, write_callback=None):
+        file_handler = ReactorFileHandler(fd, read_callback, write_callback)
+        self._fds[fd] = file_handler
+        self._c_set_fd(self._creactor, fd, self._READ)
+        return file_handler
+    def unregister_fd(self, file_handler):
+        self._c_set_fd(self._creactor, file_handler.fd, 0)
+        del self._fds[file_handler.fd]
+    def set_fd_wake(self, file_handler, is_readable=True, is_writeable=False):
+        flags = ((self._READ if is_readable else 0)
+                 | (self._WRITE if is_writeable else 0))
+        self._c_set_fd(self._creactor, file_handler.fd, flags)
+    # Main loop
+    def _dispatch_loop(self):
+        res = self._poll_result
+        busy = True
+        while self._process:
+            # Check if can sleep
+            may_sleep = not busy and not self._check_idle(
+                self._recent_eventtime)
+            # Wait for file activity and timers
+            self._c_poll(self._creactor, may_sleep, res)
+            eventtime = res.eventtime
+            if may_sleep:
+                self._start_busy_time = eventtime
+            busy = False
+            timer_ids = self._timer_ids
+            self._timer_batch = [timer_ids[res.timers[i]]
+                                 for i in range(res.timer_count)]
+            self._timer_batch_pos = 0
+            hdls = [(res.fds[i], res.fd_events[i])
+                    for i in range(res.fd_count)]
+            # Check for high latency
+            prev_etime = self._recent_eventtime
+            self._recent_eventtime = eventtime
+            if (not may_sleep
+                and eventtime - prev_etime >= self._latency_warning):
+                busy = True
+                self._dispatch_latency_callback(eventtime, prev_etime)
+            else:
+                del self._recent_callbacks[:]
+            # Dispatch file events
+            if hdls:
+                busy = True
+                did_switch = self._dispatch_fd_events(eventtime, hdls)
+                if did_switch:
+                    continue
+            # Dispatch pending timers
+            if self._timer_batch:
+                busy = True
+                self._run_timer_batch(eventtime)
+
 # Use the poll based reactor if it is available
 try:
     select.poll
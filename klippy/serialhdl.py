@@ -3,7 +3,7 @@
 # Copyright (C) 2016-2021  Kevin O'Connor <kevin@koconnor.net>
 #
 # This file may be distributed under the terms of the GNU GPLv3 license.
-import logging, threading, os
+import logging, threading, os, weakref
 import serial
 
 import msgproto, chelper, util
@@ -11,8 +11,25 @@ import msgproto, chelper, util
 class error(Exception):
     pass
 
+# A background thread that may be shared by multiple serialqueues.  It
+# is freed once the last serialqueue using it has been freed.
+shared_io_thread = None
+
+def get_shared_io_thread(ffi_main, ffi_lib):
+    global shared_io_thread
+    io_thread = None
+    if shared_io_thread is not None:
+        io_thread = shared_io_thread()
+    if io_thread is None:
+        io_thread = ffi_main.gc(
+            ffi_lib.pollreactor_thread_alloc(b"serialq shared"),
+            ffi_lib.pollreactor_thread_free)
+        shared_io_thread = weakref.ref(io_thread)
+    return io_thread
+
 class SerialReader:
-    def __init__(self, reactor, mcu_name=""):
+    def __init__(self, reactor, mcu_name="", shared_io_thread=False,
+                 adaptive_send_window=False):
         self.reactor = reactor
         self.warn_prefix = ""
         self.mcu_name = mcu_name
@@ -26,6 +43,8 @@ class SerialReader:
         # C interface
         self.ffi_main, self.ffi_lib = chelper.get_ffi()
         self.serialqueue = None
+        self.use_shared_io_thread = shared_io_thread
+        self.adaptive_send_window = adaptive_send_window
         self.default_cmd_queue = self.alloc_command_queue()
         self.stats_buf = self.ffi_main.new('char[4096]')
         # Threading
@@ -53,7 +72,7 @@ class SerialReader:
                 completion = self.pending_notifications.pop(response.notify_id)
                 self.reactor.async_complete(completion, params)
                 continue
-            params = self.msgparser.parse(response.msg[0:count])
+            params = self.msgparser.parse_cdata(response.msg, count)
             params['#sent_time'] = response.sent_time
             params['#receive_time'] = response.receive_time
             hdl = (params['#name'], params.get('oid'))
@@ -83,13 +102,22 @@ class SerialReader:
                     # Done
                     return identify_data
                 identify_data += msgdata
+    def _alloc_serialqueue(self, fd, fd_type, client_id):
+        ffi_main, ffi_lib = self.ffi_main, self.ffi_lib
+        if not self.use_shared_io_thread:
+            sq = ffi_lib.serialqueue_alloc(fd, fd_type, client_id,
+                                           self.sq_name, ffi_main.NULL)
+            return ffi_main.gc(sq, ffi_lib.serialqueue_free)
+        # The shared thread must not be freed before the serialqueue
+        io_thread = get_shared_io_thread(ffi_main, ffi_lib)
+        sq = ffi_lib.serialqueue_alloc(fd, fd_type, client_id,
+                                       self.sq_name, io_thread)
+        return ffi_main.gc(sq, (lambda sq, io_thread=io_thread:
+                                ffi_lib.serialqueue_free(sq)))
     def _start_session(self, serial_dev, serial_fd_type=b'u', client_id=0):
         self.serial_dev = serial_dev
-        self.serialqueue = self.ffi_main.gc(
-            self.ffi_lib.serialqueue_alloc(serial_dev.fileno(),
-                                           serial_fd_type, client_id,
-                                           self.sq_name),
-            self.ffi_lib.serialqueue_free)
+        self.serialqueue = self._alloc_serialqueue(
+            serial_dev.fileno(), serial_fd_type, client_id)
         self.background_thread = threading.Thread(target=self._bg_thread)
         self.background_thread.start()
         # Obtain and load the data dictionary from the firmware
@@ -101,6 +129,7 @@ class SerialReader:
             return False
         msgparser = msgproto.MessageParser(warn_prefix=self.warn_prefix)
         msgparser.process_identify(identify_data)
+        msgparser.setup_c_parser(self.ffi_main, self.ffi_lib)
         self.msgparser = msgparser
         self.register_response(self.handle_unknown, '#unknown')
         # Setup baud adjust
@@ -115,6 +144,8 @@ class SerialReader:
         if receive_window is not None:
             self.ffi_lib.serialqueue_set_receive_window(
                 self.serialqueue, receive_window)
+        if self.adaptive_send_window:
+            self.ffi_lib.serialqueue_set_adaptive_window(self.serialqueue, 1)
         return True
     def connect_canbus(self, canbus_uuid, canbus_nodeid, canbus_iface="can0"):
         import can # XXX
@@ -207,10 +238,9 @@ class SerialReader:
     def connect_file(self, debugoutput, dictionary, pace=False):
         self.serial_dev = debugoutput
         self.msgparser.process_identify(dictionary, decompress=False)
-        self.serialqueue = self.ffi_main.gc(
-            self.ffi_lib.serialqueue_alloc(self.serial_dev.fileno(), b'f', 0,
-                                           self.sq_name),
-            self.ffi_lib.serialqueue_free)
+        self.msgparser.setup_c_parser(self.ffi_main, self.ffi_lib)
+        self.serialqueue = self._alloc_serialqueue(
+            self.serial_dev.fileno(), b'f', 0)
     def set_clock_est(self, freq, conv_time, conv_clock):
         self.ffi_lib.serialqueue_set_clock_est(
             self.serialqueue, freq, conv_time, conv_clock)
@@ -129,6 +129,16 @@ class MCU_stepper:
         ffi_main, ffi_lib = chelper.get_ffi()
         ffi_lib.stepcompress_fill(self._stepqueue, self._oid, max_error_ticks,
                                   step_cmd_tag, dir_cmd_tag)
+        # Send intervals relative to the previous move (if mcu supports it)
+        delta_cmd = self._mcu.try_lookup_command(
+            "queue_step_delta oid=%c interval=%i count=%hu add=%hi")
+        if delta_cmd is not None:
+            ffi_lib.stepcompress_set_delta(self._stepqueue,
+                                           delta_cmd.get_command_tag())
+        # Check if mcu stores moves for each stepper in a dedicated queue
+        move_queue = int(constants.get('STEPPER_MOVE_QUEUE', '0'))
+        if move_queue:
+            ffi_lib.syncemitter_setup_movequeue(self._syncemitter, move_queue)
     def get_oid(self):
         return self._oid
     def get_step_dist(self):
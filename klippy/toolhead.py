@@ -42,12 +42,9 @@ class Move:
         # Junction speeds are tracked in velocity squared.  The
         # delta_v2 is the maximum amount of this squared-velocity that
         # can change in this move.
-        self.max_start_v2 = 0.
         self.max_cruise_v2 = velocity**2
         self.delta_v2 = 2.0 * move_d * self.accel
-        self.next_junction_v2 = 999999999.9
         # Setup for minimum_cruise_ratio checks
-        self.max_mcr_start_v2 = 0.
         self.mcr_delta_v2 = 2.0 * move_d * toolhead.mcr_pseudo_accel
     def limit_speed(self, speed, accel):
         speed2 = speed**2
@@ -57,73 +54,40 @@ class Move:
         self.accel = min(self.accel, accel)
         self.delta_v2 = 2.0 * self.move_d * self.accel
         self.mcr_delta_v2 = min(self.mcr_delta_v2, self.delta_v2)
-    def limit_next_junction_speed(self, speed):
-        self.next_junction_v2 = min(self.next_junction_v2, speed**2)
     def move_error(self, msg="Move out of range"):
         ep = self.end_pos
         m = "%s: %.3f %.3f %.3f [%.3f]" % (msg, ep[0], ep[1], ep[2], ep[3])
         return self.toolhead.printer.command_error(m)
-    def calc_junction(self, prev_move):
-        if not self.is_kinematic_move or not prev_move.is_kinematic_move:
-            return
+    def calc_extra_axes_junction(self, prev_move):
         # Allow extra axes to calculate maximum junction
         ea_v2 = [ea.calc_junction(prev_move, self, e_index+3)
                  for e_index, ea in enumerate(self.toolhead.extra_axes)]
-        max_start_v2 = min([self.max_cruise_v2,
-                            prev_move.max_cruise_v2, prev_move.next_junction_v2,
-                            prev_move.max_start_v2 + prev_move.delta_v2]
-                           + ea_v2)
-        # Find max velocity using "approximated centripetal velocity"
-        axes_r = self.axes_r
-        prev_axes_r = prev_move.axes_r
-        junction_cos_theta = -(axes_r[0] * prev_axes_r[0]
-                               + axes_r[1] * prev_axes_r[1]
-                               + axes_r[2] * prev_axes_r[2])
-        sin_theta_d2 = math.sqrt(max(0.5*(1.0-junction_cos_theta), 0.))
-        cos_theta_d2 = math.sqrt(max(0.5*(1.0+junction_cos_theta), 0.))
-        one_minus_sin_theta_d2 = 1. - sin_theta_d2
-        if one_minus_sin_theta_d2 > 0. and cos_theta_d2 > 0.:
-            R_jd = sin_theta_d2 / one_minus_sin_theta_d2
-            move_jd_v2 = R_jd * self.junction_deviation * self.accel
-            pmove_jd_v2 = R_jd * prev_move.junction_deviation * prev_move.accel
-            # Approximated circle must contact moves no further than mid-move
-            #   centripetal_v2 = .5 * self.move_d * self.accel * tan_theta_d2
-            quarter_tan_theta_d2 = .25 * sin_theta_d2 / cos_theta_d2
-            move_centripetal_v2 = self.delta_v2 * quarter_tan_theta_d2
-            pmove_centripetal_v2 = prev_move.delta_v2 * quarter_tan_theta_d2
-            max_start_v2 = min(max_start_v2, move_jd_v2, pmove_jd_v2,
-                               move_centripetal_v2, pmove_centripetal_v2)
-        # Apply limits
-        self.max_start_v2 = max_start_v2
-        self.max_mcr_start_v2 = min(
-            max_start_v2, prev_move.max_mcr_start_v2 + prev_move.mcr_delta_v2)
-    def set_junction(self, start_v2, cruise_v2, end_v2):
-        # Determine accel, cruise, and decel portions of the move distance
-        half_inv_accel = .5 / self.accel
-        accel_d = (cruise_v2 - start_v2) * half_inv_accel
-        decel_d = (cruise_v2 - end_v2) * half_inv_accel
-        cruise_d = self.move_d - accel_d - decel_d
-        # Determine move velocities
-        self.start_v = start_v = math.sqrt(start_v2)
-        self.cruise_v = cruise_v = math.sqrt(cruise_v2)
-        self.end_v = end_v = math.sqrt(end_v2)
-        # Determine time spent in each portion of move (time is the
-        # distance divided by average velocity)
-        self.accel_t = accel_d / ((start_v + cruise_v) * 0.5)
-        self.cruise_t = cruise_d / cruise_v
-        self.decel_t = decel_d / ((end_v + cruise_v) * 0.5)
+        return min([self.max_cruise_v2] + ea_v2)
 
 LOOKAHEAD_FLUSH_TIME = 0.150
 
 # Class to track a list of pending move requests and to facilitate
-# "look-ahead" across moves to reduce acceleration between moves.
+# "look-ahead" across moves to reduce acceleration between moves.  The
+# junction speed calculations are performed in C (see lookahead.c).
 class LookAheadQueue:
     def __init__(self):
         self.queue = []
         self.junction_flush = LOOKAHEAD_FLUSH_TIME
+        ffi_main, ffi_lib = chelper.get_ffi()
+        self._ffi_main = ffi_main
+        self.c_lookahead = ffi_main.gc(ffi_lib.lookahead_alloc(),
+                                       ffi_lib.lookahead_free)
+        self._lookahead_add_move = ffi_lib.lookahead_add_move
+        self._lookahead_flush = ffi_lib.lookahead_flush
+        self._lookahead_reset = ffi_lib.lookahead_reset
+        self._lookahead_limit_next_junction = (
+            ffi_lib.lookahead_limit_next_junction)
+        self.results = self.results_values = None
+        self.results_size = 0
     def reset(self):
         del self.queue[:]
         self.junction_flush = LOOKAHEAD_FLUSH_TIME
+        self._lookahead_reset(self.c_lookahead)
     def set_flush_time(self, flush_time):
         self.junction_flush = flush_time
     def is_empty(self):
@@ -132,66 +96,56 @@ class LookAheadQueue:
         if self.queue:
             return self.queue[-1]
         return None
+    def limit_next_junction_speed(self, speed):
+        self._lookahead_limit_next_junction(self.c_lookahead, speed**2)
     def flush(self, lazy=False):
         self.junction_flush = LOOKAHEAD_FLUSH_TIME
-        update_flush_count = lazy
         queue = self.queue
-        flush_count = len(queue)
-        # Traverse queue from last to first move and determine maximum
-        # junction speed assuming the robot comes to a complete stop
-        # after the last move.
-        junction_info = [None] * flush_count
-        next_start_v2 = next_mcr_start_v2 = peak_cruise_v2 = 0.
-        pending_cv2_assign = 0
-        for i in range(flush_count-1, -1, -1):
-            move = queue[i]
-            reachable_start_v2 = next_start_v2 + move.delta_v2
-            start_v2 = min(move.max_start_v2, reachable_start_v2)
-            cruise_v2 = None
-            pending_cv2_assign += 1
-            reach_mcr_start_v2 = next_mcr_start_v2 + move.mcr_delta_v2
-            mcr_start_v2 = min(move.max_mcr_start_v2, reach_mcr_start_v2)
-            if mcr_start_v2 < reach_mcr_start_v2:
-                # It's possible for this move to accelerate
-                if (mcr_start_v2 + move.mcr_delta_v2 > next_mcr_start_v2
-                    or pending_cv2_assign > 1):
-                    # This move can both accel and decel, or this is a
-                    # full accel move followed by a full decel move
-                    if update_flush_count and peak_cruise_v2:
-                        flush_count = i + pending_cv2_assign
-                        update_flush_count = False
-                    peak_cruise_v2 = (mcr_start_v2 + reach_mcr_start_v2) * .5
-                cruise_v2 = min((start_v2 + reachable_start_v2) * .5
-                                , move.max_cruise_v2, peak_cruise_v2)
-                pending_cv2_assign = 0
-            junction_info[i] = (move, start_v2, cruise_v2, next_start_v2)
-            next_start_v2 = start_v2
-            next_mcr_start_v2 = mcr_start_v2
-        if update_flush_count or not flush_count:
+        if not queue:
             return []
-        # Traverse queue in forward direction to propagate cruise_v2
-        prev_cruise_v2 = 0.
-        for i in range(flush_count):
-            move, start_v2, cruise_v2, next_start_v2 = junction_info[i]
-            if cruise_v2 is None:
-                # This move can't accelerate - propagate cruise_v2 from previous
-                cruise_v2 = min(prev_cruise_v2, start_v2)
-            move.set_junction(min(start_v2, cruise_v2), cruise_v2
-                              , min(next_start_v2, cruise_v2))
-            prev_cruise_v2 = cruise_v2
-        # Remove processed moves from the queue
+        if len(queue) > self.results_size:
+            self.results_size = max(len(queue), 2 * self.results_size)
+            self.results = self._ffi_main.new('struct lookahead_result[]',
+                                              self.results_size)
+            self.results_values = self._ffi_main.cast('double *', self.results)
+        flush_count = self._lookahead_flush(self.c_lookahead, lazy,
+                                            self.results)
+        if not flush_count:
+            return []
+        # Store the velocity and timing of each move
+        values = iter(self._ffi_main.unpack(self.results_values,
+                                            flush_count * 6))
         res = queue[:flush_count]
+        for move, v in zip(res, zip(values, values, values,
+                                    values, values, values)):
+            (move.start_v, move.cruise_v, move.end_v,
+             move.accel_t, move.cruise_t, move.decel_t) = v
+        # Remove processed moves from the queue
         del queue[:flush_count]
         return res
     def add_move(self, move):
-        self.queue.append(move)
-        if len(self.queue) == 1:
+        queue = self.queue
+        extra_v2 = move.max_cruise_v2
+        if queue and move.is_kinematic_move and queue[-1].is_kinematic_move:
+            extra_v2 = move.calc_extra_axes_junction(queue[-1])
+        axes_r = move.axes_r
+        ret = self._lookahead_add_move(
+            self.c_lookahead, move.is_kinematic_move, move.move_d,
+            axes_r[0], axes_r[1], axes_r[2], move.accel,
+            move.junction_deviation, move.max_cruise_v2, move.delta_v2,
+            move.mcr_delta_v2, extra_v2)
+        if ret:
+            raise move.move_error("Unable to queue move")
+        queue.append(move)
+        if len(queue) == 1:
             return
-        move.calc_junction(self.queue[-2])
         self.junction_flush -= move.min_move_t
         # Check if enough moves have been queued to reach the target flush time.
         return self.junction_flush <= 0.
 
+# Number of values per move in a trapq_append_batch() request
+TRAPQ_MOVE_VALUES = 13
+
 BUFFER_TIME_HIGH = 1.0
 BUFFER_TIME_START = 0.250
 PRIMING_CMD_TIME = 0.100
@@ -231,7 +185,8 @@ class ToolHead:
         self.motion_queuing.register_flush_callback(self._handle_step_flush,
                                                     can_add_trapq=True)
         self.trapq = self.motion_queuing.allocate_trapq()
-        self.trapq_append = self.motion_queuing.lookup_trapq_append()
+        self.trapq_append_batch = (
+            self.motion_queuing.lookup_trapq_append_batch())
         # Create kinematics class
         gcode = self.printer.lookup_object('gcode')
         self.Coord = gcode.Coord
@@ -278,25 +233,37 @@ class ToolHead:
             self._calc_print_time()
         # Queue moves into trapezoid motion queue (trapq)
         next_move_time = self.print_time
+        trapq_moves = []
         with self.reactor.assert_no_pause():
             for move in moves:
                 if move.is_kinematic_move:
-                    self.trapq_append(
-                        self.trapq, next_move_time,
-                        move.accel_t, move.cruise_t, move.decel_t,
-                        move.start_pos[0], move.start_pos[1], move.start_pos[2],
-                        move.axes_r[0], move.axes_r[1], move.axes_r[2],
-                        move.start_v, move.cruise_v, move.accel)
+                    self._buffer_trapq_move(trapq_moves, next_move_time, move)
                 for e_index, ea in enumerate(self.extra_axes):
                     if move.axes_d[e_index + 3]:
                         ea.process_move(next_move_time, move, e_index + 3)
                 next_move_time = (next_move_time + move.accel_t
                                   + move.cruise_t + move.decel_t)
-                for cb in move.timing_callbacks:
-                    cb(next_move_time)
+                if move.timing_callbacks:
+                    self._submit_trapq_moves(trapq_moves)
+                    for cb in move.timing_callbacks:
+                        cb(next_move_time)
+            self._submit_trapq_moves(trapq_moves)
         # Generate steps for moves
         self._advance_move_time(next_move_time)
         self.motion_queuing.note_mcu_movequeue_activity(next_move_time)
+    def _buffer_trapq_move(self, trapq_moves, print_time, move):
+        start_pos, axes_r = move.start_pos, move.axes_r
+        trapq_moves.extend((print_time,
+                            move.accel_t, move.cruise_t, move.decel_t,
+                            start_pos[0], start_pos[1], start_pos[2],
+                            axes_r[0], axes_r[1], axes_r[2],
+                            move.start_v, move.cruise_v, move.accel))
+    def _submit_trapq_moves(self, trapq_moves):
+        # Add buffered moves to the trapq with a single call into C
+        if trapq_moves:
+            self.trapq_append_batch(self.trapq, trapq_moves,
+                                    len(trapq_moves) // TRAPQ_MOVE_VALUES)
+            del trapq_moves[:]
     def _flush_lookahead(self, is_runout=False):
         # Transit from "NeedPrime"/"Priming"/main state to "NeedPrime"
         prev_print_time = self.print_time
@@ -389,9 +356,7 @@ class ToolHead:
         self.kin.set_position(newpos, homing_axes)
         self.printer.send_event("toolhead:set_position")
     def limit_next_junction_speed(self, speed):
-        last_move = self.lookahead.get_last()
-        if last_move is not None:
-            last_move.limit_next_junction_speed(speed)
+        self.lookahead.limit_next_junction_speed(speed)
     def move(self, newpos, speed):
         move = Move(self, self.commanded_pos, newpos, speed)
         if not move.move_d:
@@ -464,14 +429,11 @@ class ToolHead:
         moves = self.lookahead.flush()
         self._calc_print_time()
         start_time = end_time = self.print_time
+        trapq_moves = []
         for move in moves:
-            self.trapq_append(
-                self.trapq, end_time,
-                move.accel_t, move.cruise_t, move.decel_t,
-                move.start_pos[0], move.start_pos[1], move.start_pos[2],
-                move.axes_r[0], move.axes_r[1], move.axes_r[2],
-                move.start_v, move.cruise_v, move.accel)
+            self._buffer_trapq_move(trapq_moves, end_time, move)
             end_time = end_time + move.accel_t + move.cruise_t + move.decel_t
+        self._submit_trapq_moves(trapq_moves)
         self.lookahead.reset()
         return start_time, end_time
     def drip_move(self, newpos, speed, drip_completion):
@@ -562,6 +524,7 @@ class ToolHeadCommandHelper:
                                self.cmd_SET_VELOCITY_LIMIT,
                                desc=self.cmd_SET_VELOCITY_LIMIT_help)
         gcode.register_command('M204', self.cmd_M204)
+        gcode.register_fast_handler('M204', self.fast_M204)
     def cmd_G4(self, gcmd):
         # Dwell
         delay = gcmd.get_float('P', 0., minval=0.) / 1000.
@@ -600,6 +563,20 @@ class ToolHeadCommandHelper:
                 return
             accel = min(p, t)
         self.toolhead.set_max_velocities(None, accel, None, None)
+    def fast_M204(self, mask, values):
+        # Set accel (with parameters pre-parsed by the gcode fast path)
+        s, p, t = [ord(c) - ord('A') for c in 'SPT']
+        if mask & (1 << s):
+            accel = values[s]
+        elif mask & (1 << p) and mask & (1 << t):
+            accel = min(values[p], values[t])
+        else:
+            # Report error via cmd_M204()
+            return False
+        if accel <= 0.:
+            return False
+        self.toolhead.set_max_velocities(None, accel, None, None)
+        return True
 
 def add_printer_objects(config):
     printer = config.get_printer()
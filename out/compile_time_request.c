@@ -0,0 +1,1840 @@
+
+/* DO NOT EDIT! This is an autogenerated file. See scripts/buildcommands.py. */
+
+#include "board/irq.h"
+#include "board/pgm.h"
+#include "command.h"
+#include "compiler.h"
+#include "initial_pins.h"
+
+void
+ctr_run_initfuncs(void)
+{
+    extern void alloc_init(void);
+    alloc_init();
+    extern void initial_pins_setup(void);
+    initial_pins_setup();
+    extern void timer_init(void);
+    timer_init();
+    extern void serial_init(void);
+    serial_init();
+}
+
+void
+ctr_run_shutdownfuncs(void)
+{
+    extern void sendf_shutdown(void);
+    sendf_shutdown();
+    extern void move_reset(void);
+    move_reset();
+    extern void digital_out_shutdown(void);
+    digital_out_shutdown();
+    extern void stepper_shutdown(void);
+    stepper_shutdown();
+    extern void trsync_shutdown(void);
+    trsync_shutdown();
+    extern void analog_in_shutdown(void);
+    analog_in_shutdown();
+    extern void spidev_shutdown(void);
+    spidev_shutdown();
+    extern void pwm_shutdown(void);
+    pwm_shutdown();
+    extern void tmcuart_shutdown(void);
+    tmcuart_shutdown();
+    extern void st7920_shutdown(void);
+    st7920_shutdown();
+    extern void hd44780_shutdown(void);
+    hd44780_shutdown();
+}
+
+void
+ctr_run_taskfuncs(void)
+{
+    irq_poll();
+    extern void trsync_task(void);
+    trsync_task();
+    irq_poll();
+    extern void analog_in_task(void);
+    analog_in_task();
+    irq_poll();
+    extern void buttons_task(void);
+    buttons_task();
+    irq_poll();
+    extern void tmcuart_task(void);
+    tmcuart_task();
+    irq_poll();
+    extern void counter_task(void);
+    counter_task();
+    irq_poll();
+    extern void thermocouple_task(void);
+    thermocouple_task();
+    irq_poll();
+    extern void adxl345_task(void);
+    adxl345_task();
+    irq_poll();
+    extern void lis2dw_task(void);
+    lis2dw_task();
+    irq_poll();
+    extern void bmi160_task(void);
+    bmi160_task();
+    irq_poll();
+    extern void hx71x_capture_task(void);
+    hx71x_capture_task();
+    irq_poll();
+    extern void ads1220_capture_task(void);
+    ads1220_capture_task();
+    irq_poll();
+    extern void ads131m0x_capture_task(void);
+    ads131m0x_capture_task();
+    irq_poll();
+    extern void spi_angle_task(void);
+    spi_angle_task();
+    irq_poll();
+    extern void timer_task(void);
+    timer_task();
+    irq_poll();
+    extern void console_task(void);
+    console_task();
+    irq_poll();
+}
+
+uint8_t __always_inline
+ctr_lookup_static_string(const char *str)
+{
+    if (__builtin_strcmp(str, "Shutdown cleared when not shutdown") == 0)
+        return 2;
+    if (__builtin_strcmp(str, "Timer too close") == 0)
+        return 3;
+    if (__builtin_strcmp(str, "sentinel timer called") == 0)
+        return 4;
+    if (__builtin_strcmp(str, "Invalid command") == 0)
+        return 5;
+    if (__builtin_strcmp(str, "Message encode error") == 0)
+        return 6;
+    if (__builtin_strcmp(str, "Command parser error") == 0)
+        return 7;
+    if (__builtin_strcmp(str, "Command request") == 0)
+        return 8;
+    if (__builtin_strcmp(str, "config_reset only available when shutdown") == 0)
+        return 9;
+    if (__builtin_strcmp(str, "oids already allocated") == 0)
+        return 10;
+    if (__builtin_strcmp(str, "Can't assign oid") == 0)
+        return 11;
+    if (__builtin_strcmp(str, "Invalid oid type") == 0)
+        return 12;
+    if (__builtin_strcmp(str, "Already finalized") == 0)
+        return 13;
+    if (__builtin_strcmp(str, "Invalid move request size") == 0)
+        return 14;
+    if (__builtin_strcmp(str, "Move queue overflow") == 0)
+        return 15;
+    if (__builtin_strcmp(str, "alloc_chunks failed") == 0)
+        return 16;
+    if (__builtin_strcmp(str, "alloc_chunk failed") == 0)
+        return 17;
+    if (__builtin_strcmp(str, "update_digital_out not valid with active queue") == 0)
+        return 18;
+    if (__builtin_strcmp(str, "Scheduled digital out event will exceed max_duration") == 0)
+        return 19;
+    if (__builtin_strcmp(str, "Can not set soft pwm cycle ticks while updates pending") == 0)
+        return 20;
+    if (__builtin_strcmp(str, "Missed scheduling of next digital out event") == 0)
+        return 21;
+    if (__builtin_strcmp(str, "Can't reset time when stepper active") == 0)
+        return 22;
+    if (__builtin_strcmp(str, "Invalid count parameter") == 0)
+        return 23;
+    if (__builtin_strcmp(str, "Stepper too far in past") == 0)
+        return 24;
+    if (__builtin_strcmp(str, "Can't add signal that is already active") == 0)
+        return 25;
+    if (__builtin_strcmp(str, "Invalid analog_in bytes_per_report") == 0)
+        return 26;
+    if (__builtin_strcmp(str, "ADC out of range") == 0)
+        return 27;
+    if (__builtin_strcmp(str, "Invalid spi config") == 0)
+        return 28;
+    if (__builtin_strcmp(str, "Scheduled pwm event will exceed max_duration") == 0)
+        return 29;
+    if (__builtin_strcmp(str, "Missed scheduling of next hard pwm event") == 0)
+        return 30;
+    if (__builtin_strcmp(str, "Invalid buttons retransmit count") == 0)
+        return 31;
+    if (__builtin_strcmp(str, "Set button past maximum button count") == 0)
+        return 32;
+    if (__builtin_strcmp(str, "Max of 8 buttons") == 0)
+        return 33;
+    if (__builtin_strcmp(str, "tmcuart data too large") == 0)
+        return 34;
+    if (__builtin_strcmp(str, "Invalid neopixel update command") == 0)
+        return 35;
+    if (__builtin_strcmp(str, "Invalid neopixel data_size") == 0)
+        return 36;
+    if (__builtin_strcmp(str, "Thermocouple reader fault") == 0)
+        return 37;
+    if (__builtin_strcmp(str, "Invalid thermocouple chip type") == 0)
+        return 38;
+    if (__builtin_strcmp(str, "model type invalid") == 0)
+        return 39;
+    if (__builtin_strcmp(str, "bus_type invalid") == 0)
+        return 40;
+    if (__builtin_strcmp(str, "bus_type i2c unsupported") == 0)
+        return 41;
+    if (__builtin_strcmp(str, "bus_type spi unsupported") == 0)
+        return 42;
+    if (__builtin_strcmp(str, "HX71x gain/channel out of range 1-4") == 0)
+        return 43;
+    if (__builtin_strcmp(str, "Invalid ads131m0x channels configuration") == 0)
+        return 44;
+    if (__builtin_strcmp(str, "angle sensor requires cs pin") == 0)
+        return 45;
+    if (__builtin_strcmp(str, "Invalid spi_angle chip type") == 0)
+        return 46;
+    if (__builtin_strcmp(str, "Filter section index larger than max_sections") == 0)
+        return 47;
+    if (__builtin_strcmp(str, "Rescheduled timer in the past") == 0)
+        return 48;
+    return 0xff;
+}
+
+const struct initial_pin_s initial_pins[] PROGMEM = {
+};
+const int initial_pins_size PROGMEM = ARRAY_SIZE(initial_pins);
+
+static const uint8_t command_parameters0[] PROGMEM = {
+    PT_uint16 };
+static const uint8_t command_parameters1[] PROGMEM = {
+    PT_uint32, PT_uint16 };
+static const uint8_t command_parameters2[] PROGMEM = {
+    PT_uint32, PT_progmem_buffer };
+static const uint8_t command_parameters3[] PROGMEM = {
+    PT_uint32, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters4[] PROGMEM = {
+    PT_uint32, PT_uint32 };
+static const uint8_t command_parameters5[] PROGMEM = {
+    PT_uint32 };
+static const uint8_t command_parameters6[] PROGMEM = {
+    PT_byte, PT_uint32, PT_byte, PT_uint16 };
+static const uint8_t command_parameters7[] PROGMEM = {
+    PT_buffer };
+static const uint8_t command_parameters8[] PROGMEM = {
+    PT_byte, PT_int32 };
+static const uint8_t command_parameters9[] PROGMEM = {
+    PT_byte, PT_byte, PT_uint32, PT_byte };
+static const uint8_t command_parameters10[] PROGMEM = {
+    PT_byte, PT_byte, PT_byte, PT_uint32 };
+static const uint8_t command_parameters11[] PROGMEM = {
+    PT_byte, PT_uint32, PT_buffer };
+static const uint8_t command_parameters12[] PROGMEM = {
+    PT_byte, PT_buffer };
+static const uint8_t command_parameters13[] PROGMEM = {
+    PT_byte, PT_byte, PT_buffer };
+static const uint8_t command_parameters14[] PROGMEM = {
+    PT_byte, PT_byte };
+static const uint8_t command_parameters15[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters16[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_byte };
+static const uint8_t command_parameters17[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint16, PT_uint32, PT_uint16 };
+static const uint8_t command_parameters18[] PROGMEM = {
+    PT_byte, PT_uint16, PT_buffer };
+static const uint8_t command_parameters19[] PROGMEM = {
+    PT_byte, PT_byte, PT_uint32 };
+static const uint8_t command_parameters20[] PROGMEM = {
+    PT_uint32, PT_byte };
+static const uint8_t command_parameters21[] PROGMEM = {
+    PT_byte };
+static const uint8_t command_parameters22[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters23[] PROGMEM = {
+    PT_byte, PT_uint32 };
+static const uint8_t command_parameters24[] PROGMEM = {
+    PT_byte, PT_uint32, PT_byte, PT_byte, PT_uint32 };
+static const uint8_t command_parameters25[] PROGMEM = {
+    PT_byte, PT_int32, PT_uint16, PT_int16 };
+static const uint8_t command_parameters26[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint16, PT_int16 };
+static const uint8_t command_parameters27[] PROGMEM = {
+    PT_byte, PT_byte, PT_byte, PT_byte, PT_uint32 };
+static const uint8_t command_parameters28[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_byte, PT_uint32, PT_byte, PT_byte, PT_byte };
+static const uint8_t command_parameters29[] PROGMEM = {
+    PT_byte, PT_byte, PT_byte };
+static const uint8_t command_parameters30[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_byte, PT_uint32, PT_byte, PT_uint16, PT_uint16, PT_byte };
+static const uint8_t command_parameters31[] PROGMEM = {
+    PT_byte, PT_uint32, PT_byte };
+static const uint8_t command_parameters32[] PROGMEM = {
+    PT_uint32, PT_uint32, PT_uint16 };
+static const uint8_t command_parameters33[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint16 };
+static const uint8_t command_parameters34[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint16, PT_uint16, PT_uint32 };
+static const uint8_t command_parameters35[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_byte, PT_byte };
+static const uint8_t command_parameters36[] PROGMEM = {
+    PT_byte, PT_buffer, PT_byte };
+static const uint8_t command_parameters37[] PROGMEM = {
+    PT_byte, PT_uint32, PT_byte, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters38[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint16, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters39[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint32, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters40[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint32, PT_uint32, PT_uint32, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters41[] PROGMEM = {
+    PT_byte, PT_uint32, PT_uint32, PT_uint32, PT_uint32, PT_byte };
+static const uint8_t command_parameters42[] PROGMEM = {
+    PT_byte, PT_byte, PT_byte, PT_byte };
+static const uint8_t command_parameters43[] PROGMEM = {
+    PT_byte, PT_byte, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters44[] PROGMEM = {
+    PT_byte, PT_int32, PT_int32, PT_byte, PT_byte };
+static const uint8_t command_parameters45[] PROGMEM = {
+    PT_byte, PT_byte, PT_int32, PT_int32 };
+static const uint8_t command_parameters46[] PROGMEM = {
+    PT_byte, PT_byte, PT_int32, PT_int32, PT_int32, PT_int32, PT_int32 };
+static const uint8_t command_parameters47[] PROGMEM = {
+    PT_byte, PT_byte, PT_byte, PT_byte, PT_uint32, PT_uint32, PT_uint32 };
+static const uint8_t command_parameters48[] PROGMEM = {
+    PT_byte, PT_byte, PT_int32 };
+static const uint8_t command_parameters49[] PROGMEM = {
+    PT_byte, PT_int32, PT_int32 };
+
+const struct command_encoder command_encoder_100 PROGMEM = {    
+    // starting
+    .encoded_msgid=100, // msgid=-28
+    .num_params=0,
+    .param_types = 0,
+    .max_size=6,
+    .min_size=6
+};
+const struct command_encoder command_encoder_101 PROGMEM = {    
+    // is_shutdown static_string_id=%hu
+    .encoded_msgid=101, // msgid=-27
+    .num_params=1,
+    .param_types = command_parameters0,
+    .max_size=9,
+    .min_size=7
+};
+const struct command_encoder command_encoder_102 PROGMEM = {    
+    // shutdown clock=%u static_string_id=%hu
+    .encoded_msgid=102, // msgid=-26
+    .num_params=2,
+    .param_types = command_parameters1,
+    .max_size=14,
+    .min_size=8
+};
+const struct command_encoder command_encoder_0 PROGMEM = {    
+    // identify_response offset=%u data=%.*s
+    .encoded_msgid=0, // msgid=0
+    .num_params=2,
+    .param_types = command_parameters2,
+    .max_size=64,
+    .min_size=8
+};
+const struct command_encoder command_encoder_103 PROGMEM = {    
+    // stats count=%u sum=%u sumsq=%u
+    .encoded_msgid=103, // msgid=-25
+    .num_params=3,
+    .param_types = command_parameters3,
+    .max_size=21,
+    .min_size=9
+};
+const struct command_encoder command_encoder_104 PROGMEM = {    
+    // uptime high=%u clock=%u
+    .encoded_msgid=104, // msgid=-24
+    .num_params=2,
+    .param_types = command_parameters4,
+    .max_size=16,
+    .min_size=8
+};
+const struct command_encoder command_encoder_105 PROGMEM = {    
+    // clock clock=%u
+    .encoded_msgid=105, // msgid=-23
+    .num_params=1,
+    .param_types = command_parameters5,
+    .max_size=11,
+    .min_size=7
+};
+const struct command_encoder command_encoder_106 PROGMEM = {    
+    // config is_config=%c crc=%u is_shutdown=%c move_count=%hu
+    .encoded_msgid=106, // msgid=-22
+    .num_params=4,
+    .param_types = command_parameters6,
+    .max_size=18,
+    .min_size=10
+};
+const struct command_encoder command_encoder_107 PROGMEM = {    
+    // pong data=%*s
+    .encoded_msgid=107, // msgid=-21
+    .num_params=1,
+    .param_types = command_parameters7,
+    .max_size=64,
+    .min_size=7
+};
+const struct command_encoder command_encoder_108 PROGMEM = {    
+    // debug_result val=%u
+    .encoded_msgid=108, // msgid=-20
+    .num_params=1,
+    .param_types = command_parameters5,
+    .max_size=11,
+    .min_size=7
+};
+const struct command_encoder command_encoder_109 PROGMEM = {    
+    // stepper_position oid=%c pos=%i
+    .encoded_msgid=109, // msgid=-19
+    .num_params=2,
+    .param_types = command_parameters8,
+    .max_size=13,
+    .min_size=8
+};
+const struct command_encoder command_encoder_110 PROGMEM = {    
+    // endstop_state oid=%c homing=%c next_clock=%u pin_value=%c
+    .encoded_msgid=110, // msgid=-18
+    .num_params=4,
+    .param_types = command_parameters9,
+    .max_size=17,
+    .min_size=10
+};
+const struct command_encoder command_encoder_111 PROGMEM = {    
+    // trsync_state oid=%c can_trigger=%c trigger_reason=%c clock=%u
+    .encoded_msgid=111, // msgid=-17
+    .num_params=4,
+    .param_types = command_parameters10,
+    .max_size=17,
+    .min_size=10
+};
+const struct command_encoder command_encoder_112 PROGMEM = {    
+    // analog_in_state oid=%c next_clock=%u values=%*s
+    .encoded_msgid=112, // msgid=-16
+    .num_params=3,
+    .param_types = command_parameters11,
+    .max_size=64,
+    .min_size=9
+};
+const struct command_encoder command_encoder_113 PROGMEM = {    
+    // spi_transfer_response oid=%c response=%*s
+    .encoded_msgid=113, // msgid=-15
+    .num_params=2,
+    .param_types = command_parameters12,
+    .max_size=64,
+    .min_size=8
+};
+const struct command_encoder command_encoder_114 PROGMEM = {    
+    // buttons_state oid=%c ack_count=%c state=%*s
+    .encoded_msgid=114, // msgid=-14
+    .num_params=3,
+    .param_types = command_parameters13,
+    .max_size=64,
+    .min_size=9
+};
+const struct command_encoder command_encoder_115 PROGMEM = {    
+    // tmcuart_response oid=%c read=%*s
+    .encoded_msgid=115, // msgid=-13
+    .num_params=2,
+    .param_types = command_parameters12,
+    .max_size=64,
+    .min_size=8
+};
+const struct command_encoder command_encoder_116 PROGMEM = {    
+    // neopixel_result oid=%c success=%c
+    .encoded_msgid=116, // msgid=-12
+    .num_params=2,
+    .param_types = command_parameters14,
+    .max_size=10,
+    .min_size=8
+};
+const struct command_encoder command_encoder_117 PROGMEM = {    
+    // counter_state oid=%c next_clock=%u count=%u count_clock=%u
+    .encoded_msgid=117, // msgid=-11
+    .num_params=4,
+    .param_types = command_parameters15,
+    .max_size=23,
+    .min_size=10
+};
+const struct command_encoder command_encoder_118 PROGMEM = {    
+    // thermocouple_result oid=%c next_clock=%u value=%u fault=%c
+    .encoded_msgid=118, // msgid=-10
+    .num_params=4,
+    .param_types = command_parameters16,
+    .max_size=20,
+    .min_size=10
+};
+const struct command_encoder command_encoder_119 PROGMEM = {    
+    // spi_angle_transfer_response oid=%c clock=%u response=%*s
+    .encoded_msgid=119, // msgid=-9
+    .num_params=3,
+    .param_types = command_parameters11,
+    .max_size=64,
+    .min_size=9
+};
+const struct command_encoder command_encoder_120 PROGMEM = {    
+    // sensor_bulk_status oid=%c clock=%u query_ticks=%u next_sequence=%hu buffered=%u possible_overflows=%hu
+    .encoded_msgid=120, // msgid=-8
+    .num_params=6,
+    .param_types = command_parameters17,
+    .max_size=29,
+    .min_size=12
+};
+const struct command_encoder command_encoder_121 PROGMEM = {    
+    // sensor_bulk_data oid=%c sequence=%hu data=%*s
+    .encoded_msgid=121, // msgid=-7
+    .num_params=3,
+    .param_types = command_parameters18,
+    .max_size=64,
+    .min_size=9
+};
+const struct command_encoder command_encoder_122 PROGMEM = {    
+    // trigger_analog_state oid=%c homing=%c homing_clock=%u
+    .encoded_msgid=122, // msgid=-6
+    .num_params=3,
+    .param_types = command_parameters19,
+    .max_size=15,
+    .min_size=9
+};
+
+const __always_inline struct command_encoder *
+ctr_lookup_encoder(const char *str)
+{
+    if (__builtin_strcmp(str, "starting") == 0)
+        return &command_encoder_100;
+    if (__builtin_strcmp(str, "is_shutdown static_string_id=%hu") == 0)
+        return &command_encoder_101;
+    if (__builtin_strcmp(str, "shutdown clock=%u static_string_id=%hu") == 0)
+        return &command_encoder_102;
+    if (__builtin_strcmp(str, "identify_response offset=%u data=%.*s") == 0)
+        return &command_encoder_0;
+    if (__builtin_strcmp(str, "stats count=%u sum=%u sumsq=%u") == 0)
+        return &command_encoder_103;
+    if (__builtin_strcmp(str, "uptime high=%u clock=%u") == 0)
+        return &command_encoder_104;
+    if (__builtin_strcmp(str, "clock clock=%u") == 0)
+        return &command_encoder_105;
+    if (__builtin_strcmp(str, "config is_config=%c crc=%u is_shutdown=%c move_count=%hu") == 0)
+        return &command_encoder_106;
+    if (__builtin_strcmp(str, "pong data=%*s") == 0)
+        return &command_encoder_107;
+    if (__builtin_strcmp(str, "debug_result val=%u") == 0)
+        return &command_encoder_108;
+    if (__builtin_strcmp(str, "stepper_position oid=%c pos=%i") == 0)
+        return &command_encoder_109;
+    if (__builtin_strcmp(str, "endstop_state oid=%c homing=%c next_clock=%u pin_value=%c") == 0)
+        return &command_encoder_110;
+    if (__builtin_strcmp(str, "trsync_state oid=%c can_trigger=%c trigger_reason=%c clock=%u") == 0)
+        return &command_encoder_111;
+    if (__builtin_strcmp(str, "analog_in_state oid=%c next_clock=%u values=%*s") == 0)
+        return &command_encoder_112;
+    if (__builtin_strcmp(str, "spi_transfer_response oid=%c response=%*s") == 0)
+        return &command_encoder_113;
+    if (__builtin_strcmp(str, "buttons_state oid=%c ack_count=%c state=%*s") == 0)
+        return &command_encoder_114;
+    if (__builtin_strcmp(str, "tmcuart_response oid=%c read=%*s") == 0)
+        return &command_encoder_115;
+    if (__builtin_strcmp(str, "neopixel_result oid=%c success=%c") == 0)
+        return &command_encoder_116;
+    if (__builtin_strcmp(str, "counter_state oid=%c next_clock=%u count=%u count_clock=%u") == 0)
+        return &command_encoder_117;
+    if (__builtin_strcmp(str, "thermocouple_result oid=%c next_clock=%u value=%u fault=%c") == 0)
+        return &command_encoder_118;
+    if (__builtin_strcmp(str, "spi_angle_transfer_response oid=%c clock=%u response=%*s") == 0)
+        return &command_encoder_119;
+    if (__builtin_strcmp(str, "sensor_bulk_status oid=%c clock=%u query_ticks=%u next_sequence=%hu buffered=%u possible_overflows=%hu") == 0)
+        return &command_encoder_120;
+    if (__builtin_strcmp(str, "sensor_bulk_data oid=%c sequence=%hu data=%*s") == 0)
+        return &command_encoder_121;
+    if (__builtin_strcmp(str, "trigger_analog_state oid=%c homing=%c homing_clock=%u") == 0)
+        return &command_encoder_122;
+    return NULL;
+}
+
+const __always_inline struct command_encoder *
+ctr_lookup_output(const char *str)
+{
+    
+    return NULL;
+}
+
+extern void ads1220_attach_trigger_analog(uint32_t*);
+extern void ads131m0x_attach_trigger_analog(uint32_t*);
+extern void command_allocate_oids(uint32_t*);
+extern void command_analog_in_attach_trigger_analog(uint32_t*);
+extern void command_buttons_ack(uint32_t*);
+extern void command_buttons_add(uint32_t*);
+extern void command_buttons_query(uint32_t*);
+extern void command_clear_shutdown(uint32_t*);
+extern void command_config_ads1220(uint32_t*);
+extern void command_config_ads131m0x(uint32_t*);
+extern void command_config_adxl345(uint32_t*);
+extern void command_config_analog_in(uint32_t*);
+extern void command_config_bmi160(uint32_t*);
+extern void command_config_buttons(uint32_t*);
+extern void command_config_counter(uint32_t*);
+extern void command_config_digital_out(uint32_t*);
+extern void command_config_endstop(uint32_t*);
+extern void command_config_hd44780(uint32_t*);
+extern void command_config_hx71x(uint32_t*);
+extern void command_config_lis2dw(uint32_t*);
+extern void command_config_neopixel(uint32_t*);
+extern void command_config_pwm_out(uint32_t*);
+extern void command_config_sos_filter(uint32_t*);
+extern void command_config_spi(uint32_t*);
+extern void command_config_spi_angle(uint32_t*);
+extern void command_config_spi_shutdown(uint32_t*);
+extern void command_config_spi_without_cs(uint32_t*);
+extern void command_config_st7920(uint32_t*);
+extern void command_config_stepper(uint32_t*);
+extern void command_config_thermocouple(uint32_t*);
+extern void command_config_tmcuart(uint32_t*);
+extern void command_config_trigger_analog(uint32_t*);
+extern void command_config_trsync(uint32_t*);
+extern void command_debug_nop(uint32_t*);
+extern void command_debug_ping(uint32_t*);
+extern void command_debug_read(uint32_t*);
+extern void command_debug_write(uint32_t*);
+extern void command_emergency_stop(uint32_t*);
+extern void command_endstop_home(uint32_t*);
+extern void command_endstop_query_state(uint32_t*);
+extern void command_finalize_config(uint32_t*);
+extern void command_get_clock(uint32_t*);
+extern void command_get_config(uint32_t*);
+extern void command_get_uptime(uint32_t*);
+extern void command_hd44780_send_cmds(uint32_t*);
+extern void command_hd44780_send_data(uint32_t*);
+extern void command_identify(uint32_t*);
+extern void command_neopixel_send(uint32_t*);
+extern void command_neopixel_update(uint32_t*);
+extern void command_query_ads1220(uint32_t*);
+extern void command_query_ads1220_status(uint32_t*);
+extern void command_query_ads131m0x(uint32_t*);
+extern void command_query_ads131m0x_status(uint32_t*);
+extern void command_query_adxl345(uint32_t*);
+extern void command_query_adxl345_status(uint32_t*);
+extern void command_query_analog_in(uint32_t*);
+extern void command_query_bmi160(uint32_t*);
+extern void command_query_bmi160_status(uint32_t*);
+extern void command_query_counter(uint32_t*);
+extern void command_query_hx71x(uint32_t*);
+extern void command_query_hx71x_status(uint32_t*);
+extern void command_query_lis2dw(uint32_t*);
+extern void command_query_lis2dw_status(uint32_t*);
+extern void command_query_spi_angle(uint32_t*);
+extern void command_query_thermocouple(uint32_t*);
+extern void command_queue_digital_out(uint32_t*);
+extern void command_queue_pwm_out(uint32_t*);
+extern void command_queue_step(uint32_t*);
+extern void command_queue_step_delta(uint32_t*);
+extern void command_queue_steps(uint32_t*);
+extern void command_queue_steps_delta(uint32_t*);
+extern void command_reset_step_clock(uint32_t*);
+extern void command_set_digital_out(uint32_t*);
+extern void command_set_digital_out_pwm_cycle(uint32_t*);
+extern void command_set_next_step_dir(uint32_t*);
+extern void command_set_pwm_out(uint32_t*);
+extern void command_sos_filter_activate(uint32_t*);
+extern void command_sos_filter_set_section(uint32_t*);
+extern void command_sos_filter_set_state(uint32_t*);
+extern void command_spi_angle_transfer(uint32_t*);
+extern void command_spi_send(uint32_t*);
+extern void command_spi_set_bus(uint32_t*);
+extern void command_spi_set_sw_bus(uint32_t*);
+extern void command_spi_transfer(uint32_t*);
+extern void command_st7920_send_cmds(uint32_t*);
+extern void command_st7920_send_data(uint32_t*);
+extern void command_stepper_get_position(uint32_t*);
+extern void command_stepper_stop_on_trigger(uint32_t*);
+extern void command_tmcuart_send(uint32_t*);
+extern void command_trigger_analog_home(uint32_t*);
+extern void command_trigger_analog_query_state(uint32_t*);
+extern void command_trigger_analog_set_offset_scale(uint32_t*);
+extern void command_trigger_analog_set_raw_range(uint32_t*);
+extern void command_trigger_analog_set_trigger(uint32_t*);
+extern void command_trsync_set_timeout(uint32_t*);
+extern void command_trsync_start(uint32_t*);
+extern void command_trsync_trigger(uint32_t*);
+extern void command_update_digital_out(uint32_t*);
+extern void hx71x_attach_trigger_analog(uint32_t*);
+
+const struct command_parser command_index[] PROGMEM = {
+{
+}, {
+    // identify offset=%u count=%c
+    .encoded_msgid=1, // msgid=1
+    .num_params=2,
+    .param_types = command_parameters20,
+    .num_args=2,
+    .flags=0x01,
+    .func=command_identify
+}, {
+    // clear_shutdown
+    .encoded_msgid=2, // msgid=2
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_clear_shutdown
+}, {
+    // emergency_stop
+    .encoded_msgid=3, // msgid=3
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_emergency_stop
+}, {
+    // get_uptime
+    .encoded_msgid=4, // msgid=4
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_get_uptime
+}, {
+    // get_clock
+    .encoded_msgid=5, // msgid=5
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_get_clock
+}, {
+    // finalize_config crc=%u
+    .encoded_msgid=6, // msgid=6
+    .num_params=1,
+    .param_types = command_parameters5,
+    .num_args=1,
+    .flags=0,
+    .func=command_finalize_config
+}, {
+    // get_config
+    .encoded_msgid=7, // msgid=7
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_get_config
+}, {
+    // allocate_oids count=%c
+    .encoded_msgid=8, // msgid=8
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_allocate_oids
+}, {
+    // debug_nop
+    .encoded_msgid=9, // msgid=9
+    .num_params=0,
+    .param_types = 0,
+    .num_args=0,
+    .flags=0x01,
+    .func=command_debug_nop
+}, {
+    // debug_ping data=%*s
+    .encoded_msgid=10, // msgid=10
+    .num_params=1,
+    .param_types = command_parameters7,
+    .num_args=2,
+    .flags=0x01,
+    .func=command_debug_ping
+}, {
+    // debug_write order=%c addr=%u val=%u
+    .encoded_msgid=11, // msgid=11
+    .num_params=3,
+    .param_types = command_parameters22,
+    .num_args=3,
+    .flags=0x01,
+    .func=command_debug_write
+}, {
+    // debug_read order=%c addr=%u
+    .encoded_msgid=12, // msgid=12
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0x01,
+    .func=command_debug_read
+}, {
+    // set_digital_out pin=%u value=%c
+    .encoded_msgid=13, // msgid=13
+    .num_params=2,
+    .param_types = command_parameters20,
+    .num_args=2,
+    .flags=0,
+    .func=command_set_digital_out
+}, {
+    // update_digital_out oid=%c value=%c
+    .encoded_msgid=14, // msgid=14
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_update_digital_out
+}, {
+    // queue_digital_out oid=%c clock=%u on_ticks=%u
+    .encoded_msgid=15, // msgid=15
+    .num_params=3,
+    .param_types = command_parameters22,
+    .num_args=3,
+    .flags=0,
+    .func=command_queue_digital_out
+}, {
+    // set_digital_out_pwm_cycle oid=%c cycle_ticks=%u
+    .encoded_msgid=16, // msgid=16
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_set_digital_out_pwm_cycle
+}, {
+    // config_digital_out oid=%c pin=%u value=%c default_value=%c max_duration=%u
+    .encoded_msgid=17, // msgid=17
+    .num_params=5,
+    .param_types = command_parameters24,
+    .num_args=5,
+    .flags=0,
+    .func=command_config_digital_out
+}, {
+    // stepper_stop_on_trigger oid=%c trsync_oid=%c
+    .encoded_msgid=18, // msgid=18
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_stepper_stop_on_trigger
+}, {
+    // stepper_get_position oid=%c
+    .encoded_msgid=19, // msgid=19
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_stepper_get_position
+}, {
+    // reset_step_clock oid=%c clock=%u
+    .encoded_msgid=20, // msgid=20
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_reset_step_clock
+}, {
+    // set_next_step_dir oid=%c dir=%c
+    .encoded_msgid=21, // msgid=21
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_set_next_step_dir
+}, {
+    // queue_steps_delta data=%*s
+    .encoded_msgid=22, // msgid=22
+    .num_params=1,
+    .param_types = command_parameters7,
+    .num_args=2,
+    .flags=0,
+    .func=command_queue_steps_delta
+}, {
+    // queue_steps data=%*s
+    .encoded_msgid=23, // msgid=23
+    .num_params=1,
+    .param_types = command_parameters7,
+    .num_args=2,
+    .flags=0,
+    .func=command_queue_steps
+}, {
+    // queue_step_delta oid=%c interval=%i count=%hu add=%hi
+    .encoded_msgid=24, // msgid=24
+    .num_params=4,
+    .param_types = command_parameters25,
+    .num_args=4,
+    .flags=0,
+    .func=command_queue_step_delta
+}, {
+    // queue_step oid=%c interval=%u count=%hu add=%hi
+    .encoded_msgid=25, // msgid=25
+    .num_params=4,
+    .param_types = command_parameters26,
+    .num_args=4,
+    .flags=0,
+    .func=command_queue_step
+}, {
+    // config_stepper oid=%c step_pin=%c dir_pin=%c invert_step=%c step_pulse_ticks=%u
+    .encoded_msgid=26, // msgid=26
+    .num_params=5,
+    .param_types = command_parameters27,
+    .num_args=5,
+    .flags=0,
+    .func=command_config_stepper
+}, {
+    // endstop_query_state oid=%c
+    .encoded_msgid=27, // msgid=27
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_endstop_query_state
+}, {
+    // endstop_home oid=%c clock=%u sample_ticks=%u sample_count=%c rest_ticks=%u pin_value=%c trsync_oid=%c trigger_reason=%c
+    .encoded_msgid=28, // msgid=28
+    .num_params=8,
+    .param_types = command_parameters28,
+    .num_args=8,
+    .flags=0,
+    .func=command_endstop_home
+}, {
+    // config_endstop oid=%c pin=%c pull_up=%c
+    .encoded_msgid=29, // msgid=29
+    .num_params=3,
+    .param_types = command_parameters29,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_endstop
+}, {
+    // trsync_trigger oid=%c reason=%c
+    .encoded_msgid=30, // msgid=30
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_trsync_trigger
+}, {
+    // trsync_set_timeout oid=%c clock=%u
+    .encoded_msgid=31, // msgid=31
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_trsync_set_timeout
+}, {
+    // trsync_start oid=%c report_clock=%u report_ticks=%u expire_reason=%c
+    .encoded_msgid=32, // msgid=32
+    .num_params=4,
+    .param_types = command_parameters16,
+    .num_args=4,
+    .flags=0,
+    .func=command_trsync_start
+}, {
+    // config_trsync oid=%c
+    .encoded_msgid=33, // msgid=33
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_config_trsync
+}, {
+    // analog_in_attach_trigger_analog oid=%c trigger_analog_oid=%c
+    .encoded_msgid=34, // msgid=34
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_analog_in_attach_trigger_analog
+}, {
+    // query_analog_in oid=%c clock=%u sample_ticks=%u sample_count=%c rest_ticks=%u bytes_per_report=%c min_value=%hu max_value=%hu range_check_count=%c
+    .encoded_msgid=35, // msgid=35
+    .num_params=9,
+    .param_types = command_parameters30,
+    .num_args=9,
+    .flags=0,
+    .func=command_query_analog_in
+}, {
+    // config_analog_in oid=%c pin=%u
+    .encoded_msgid=36, // msgid=36
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_config_analog_in
+}, {
+    // config_spi_shutdown oid=%c spi_oid=%c shutdown_msg=%*s
+    .encoded_msgid=37, // msgid=37
+    .num_params=3,
+    .param_types = command_parameters13,
+    .num_args=4,
+    .flags=0,
+    .func=command_config_spi_shutdown
+}, {
+    // spi_send oid=%c data=%*s
+    .encoded_msgid=38, // msgid=38
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_spi_send
+}, {
+    // spi_transfer oid=%c data=%*s
+    .encoded_msgid=39, // msgid=39
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_spi_transfer
+}, {
+    // spi_set_bus oid=%c spi_bus=%u mode=%u rate=%u
+    .encoded_msgid=40, // msgid=40
+    .num_params=4,
+    .param_types = command_parameters15,
+    .num_args=4,
+    .flags=0,
+    .func=command_spi_set_bus
+}, {
+    // config_spi_without_cs oid=%c
+    .encoded_msgid=41, // msgid=41
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_config_spi_without_cs
+}, {
+    // config_spi oid=%c pin=%u cs_active_high=%c
+    .encoded_msgid=42, // msgid=42
+    .num_params=3,
+    .param_types = command_parameters31,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_spi
+}, {
+    // set_pwm_out pin=%u cycle_ticks=%u value=%hu
+    .encoded_msgid=43, // msgid=43
+    .num_params=3,
+    .param_types = command_parameters32,
+    .num_args=3,
+    .flags=0,
+    .func=command_set_pwm_out
+}, {
+    // queue_pwm_out oid=%c clock=%u value=%hu
+    .encoded_msgid=44, // msgid=44
+    .num_params=3,
+    .param_types = command_parameters33,
+    .num_args=3,
+    .flags=0,
+    .func=command_queue_pwm_out
+}, {
+    // config_pwm_out oid=%c pin=%u cycle_ticks=%u value=%hu default_value=%hu max_duration=%u
+    .encoded_msgid=45, // msgid=45
+    .num_params=6,
+    .param_types = command_parameters34,
+    .num_args=6,
+    .flags=0,
+    .func=command_config_pwm_out
+}, {
+    // buttons_ack oid=%c count=%c
+    .encoded_msgid=46, // msgid=46
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_buttons_ack
+}, {
+    // buttons_query oid=%c clock=%u rest_ticks=%u retransmit_count=%c invert=%c
+    .encoded_msgid=47, // msgid=47
+    .num_params=5,
+    .param_types = command_parameters35,
+    .num_args=5,
+    .flags=0,
+    .func=command_buttons_query
+}, {
+    // buttons_add oid=%c pos=%c pin=%u pull_up=%c
+    .encoded_msgid=48, // msgid=48
+    .num_params=4,
+    .param_types = command_parameters9,
+    .num_args=4,
+    .flags=0,
+    .func=command_buttons_add
+}, {
+    // config_buttons oid=%c button_count=%c
+    .encoded_msgid=49, // msgid=49
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_config_buttons
+}, {
+    // tmcuart_send oid=%c write=%*s read=%c
+    .encoded_msgid=50, // msgid=50
+    .num_params=3,
+    .param_types = command_parameters36,
+    .num_args=4,
+    .flags=0,
+    .func=command_tmcuart_send
+}, {
+    // config_tmcuart oid=%c rx_pin=%u pull_up=%c tx_pin=%u bit_time=%u
+    .encoded_msgid=51, // msgid=51
+    .num_params=5,
+    .param_types = command_parameters37,
+    .num_args=5,
+    .flags=0,
+    .func=command_config_tmcuart
+}, {
+    // neopixel_send oid=%c
+    .encoded_msgid=52, // msgid=52
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_neopixel_send
+}, {
+    // neopixel_update oid=%c pos=%hu data=%*s
+    .encoded_msgid=53, // msgid=53
+    .num_params=3,
+    .param_types = command_parameters18,
+    .num_args=4,
+    .flags=0,
+    .func=command_neopixel_update
+}, {
+    // config_neopixel oid=%c pin=%u data_size=%hu bit_max_ticks=%u reset_min_ticks=%u
+    .encoded_msgid=54, // msgid=54
+    .num_params=5,
+    .param_types = command_parameters38,
+    .num_args=5,
+    .flags=0,
+    .func=command_config_neopixel
+}, {
+    // query_counter oid=%c clock=%u poll_ticks=%u sample_ticks=%u
+    .encoded_msgid=55, // msgid=55
+    .num_params=4,
+    .param_types = command_parameters15,
+    .num_args=4,
+    .flags=0,
+    .func=command_query_counter
+}, {
+    // config_counter oid=%c pin=%u pull_up=%c
+    .encoded_msgid=56, // msgid=56
+    .num_params=3,
+    .param_types = command_parameters31,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_counter
+}, {
+    // st7920_send_data oid=%c data=%*s
+    .encoded_msgid=57, // msgid=57
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_st7920_send_data
+}, {
+    // st7920_send_cmds oid=%c cmds=%*s
+    .encoded_msgid=58, // msgid=58
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_st7920_send_cmds
+}, {
+    // config_st7920 oid=%c cs_pin=%u sclk_pin=%u sid_pin=%u sync_delay_ticks=%u cmd_delay_ticks=%u
+    .encoded_msgid=59, // msgid=59
+    .num_params=6,
+    .param_types = command_parameters39,
+    .num_args=6,
+    .flags=0,
+    .func=command_config_st7920
+}, {
+    // hd44780_send_data oid=%c data=%*s
+    .encoded_msgid=60, // msgid=60
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_hd44780_send_data
+}, {
+    // hd44780_send_cmds oid=%c cmds=%*s
+    .encoded_msgid=61, // msgid=61
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_hd44780_send_cmds
+}, {
+    // config_hd44780 oid=%c rs_pin=%u e_pin=%u d4_pin=%u d5_pin=%u d6_pin=%u d7_pin=%u delay_ticks=%u
+    .encoded_msgid=62, // msgid=62
+    .num_params=8,
+    .param_types = command_parameters40,
+    .num_args=8,
+    .flags=0,
+    .func=command_config_hd44780
+}, {
+    // spi_set_sw_bus oid=%c miso_pin=%u mosi_pin=%u sclk_pin=%u mode=%u pulse_ticks=%u
+    .encoded_msgid=63, // msgid=63
+    .num_params=6,
+    .param_types = command_parameters39,
+    .num_args=6,
+    .flags=0,
+    .func=command_spi_set_sw_bus
+}, {
+    // query_thermocouple oid=%c clock=%u rest_ticks=%u min_value=%u max_value=%u max_invalid_count=%c
+    .encoded_msgid=64, // msgid=64
+    .num_params=6,
+    .param_types = command_parameters41,
+    .num_args=6,
+    .flags=0,
+    .func=command_query_thermocouple
+}, {
+    // config_thermocouple oid=%c spi_oid=%c thermocouple_type=%c
+    .encoded_msgid=65, // msgid=65
+    .num_params=3,
+    .param_types = command_parameters29,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_thermocouple
+}, {
+    // query_adxl345_status oid=%c
+    .encoded_msgid=66, // msgid=66
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_adxl345_status
+}, {
+    // query_adxl345 oid=%c rest_ticks=%u
+    .encoded_msgid=67, // msgid=67
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_adxl345
+}, {
+    // config_adxl345 oid=%c spi_oid=%c
+    .encoded_msgid=68, // msgid=68
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_config_adxl345
+}, {
+    // query_lis2dw_status oid=%c
+    .encoded_msgid=69, // msgid=69
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_lis2dw_status
+}, {
+    // query_lis2dw oid=%c rest_ticks=%u
+    .encoded_msgid=70, // msgid=70
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_lis2dw
+}, {
+    // config_lis2dw oid=%c bus_oid=%c bus_oid_type=%c lis_chip_type=%c
+    .encoded_msgid=71, // msgid=71
+    .num_params=4,
+    .param_types = command_parameters42,
+    .num_args=4,
+    .flags=0,
+    .func=command_config_lis2dw
+}, {
+    // query_bmi160_status oid=%c
+    .encoded_msgid=72, // msgid=72
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_bmi160_status
+}, {
+    // query_bmi160 oid=%c rest_ticks=%u
+    .encoded_msgid=73, // msgid=73
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_bmi160
+}, {
+    // config_bmi160 oid=%c bus_oid=%c bus_oid_type=%c
+    .encoded_msgid=74, // msgid=74
+    .num_params=3,
+    .param_types = command_parameters29,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_bmi160
+}, {
+    // query_hx71x_status oid=%c
+    .encoded_msgid=75, // msgid=75
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_hx71x_status
+}, {
+    // query_hx71x oid=%c rest_ticks=%u
+    .encoded_msgid=76, // msgid=76
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_hx71x
+}, {
+    // hx71x_attach_trigger_analog oid=%c trigger_analog_oid=%c
+    .encoded_msgid=77, // msgid=77
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=hx71x_attach_trigger_analog
+}, {
+    // config_hx71x oid=%c gain_channel=%c dout_pin=%u sclk_pin=%u
+    .encoded_msgid=78, // msgid=78
+    .num_params=4,
+    .param_types = command_parameters43,
+    .num_args=4,
+    .flags=0,
+    .func=command_config_hx71x
+}, {
+    // query_ads1220_status oid=%c
+    .encoded_msgid=79, // msgid=79
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_ads1220_status
+}, {
+    // query_ads1220 oid=%c rest_ticks=%u
+    .encoded_msgid=80, // msgid=80
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_ads1220
+}, {
+    // ads1220_attach_trigger_analog oid=%c trigger_analog_oid=%c
+    .encoded_msgid=81, // msgid=81
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=ads1220_attach_trigger_analog
+}, {
+    // config_ads1220 oid=%c spi_oid=%c data_ready_pin=%u
+    .encoded_msgid=82, // msgid=82
+    .num_params=3,
+    .param_types = command_parameters19,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_ads1220
+}, {
+    // query_ads131m0x_status oid=%c
+    .encoded_msgid=83, // msgid=83
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_query_ads131m0x_status
+}, {
+    // query_ads131m0x oid=%c rest_ticks=%u
+    .encoded_msgid=84, // msgid=84
+    .num_params=2,
+    .param_types = command_parameters23,
+    .num_args=2,
+    .flags=0,
+    .func=command_query_ads131m0x
+}, {
+    // ads131m0x_attach_trigger_analog oid=%c trigger_analog_oid=%c
+    .encoded_msgid=85, // msgid=85
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=ads131m0x_attach_trigger_analog
+}, {
+    // config_ads131m0x oid=%c spi_oid=%c channel=%c num_channels=%c data_ready_pin=%u
+    .encoded_msgid=86, // msgid=86
+    .num_params=5,
+    .param_types = command_parameters27,
+    .num_args=5,
+    .flags=0,
+    .func=command_config_ads131m0x
+}, {
+    // spi_angle_transfer oid=%c data=%*s
+    .encoded_msgid=87, // msgid=87
+    .num_params=2,
+    .param_types = command_parameters12,
+    .num_args=3,
+    .flags=0,
+    .func=command_spi_angle_transfer
+}, {
+    // query_spi_angle oid=%c clock=%u rest_ticks=%u time_shift=%c
+    .encoded_msgid=88, // msgid=88
+    .num_params=4,
+    .param_types = command_parameters16,
+    .num_args=4,
+    .flags=0,
+    .func=command_query_spi_angle
+}, {
+    // config_spi_angle oid=%c spi_oid=%c spi_angle_type=%c
+    .encoded_msgid=89, // msgid=89
+    .num_params=3,
+    .param_types = command_parameters29,
+    .num_args=3,
+    .flags=0,
+    .func=command_config_spi_angle
+}, {
+    // sos_filter_set_active oid=%c n_sections=%c coeff_frac_bits=%c
+    .encoded_msgid=90, // msgid=90
+    .num_params=3,
+    .param_types = command_parameters29,
+    .num_args=3,
+    .flags=0,
+    .func=command_sos_filter_activate
+}, {
+    // sos_filter_set_offset_scale oid=%c offset=%i scale=%i scale_frac_bits=%c auto_offset=%c
+    .encoded_msgid=91, // msgid=91
+    .num_params=5,
+    .param_types = command_parameters44,
+    .num_args=5,
+    .flags=0,
+    .func=command_trigger_analog_set_offset_scale
+}, {
+    // sos_filter_set_state oid=%c section_idx=%c state0=%i state1=%i
+    .encoded_msgid=92, // msgid=92
+    .num_params=4,
+    .param_types = command_parameters45,
+    .num_args=4,
+    .flags=0,
+    .func=command_sos_filter_set_state
+}, {
+    // sos_filter_set_section oid=%c section_idx=%c sos0=%i sos1=%i sos2=%i sos3=%i sos4=%i
+    .encoded_msgid=93, // msgid=93
+    .num_params=7,
+    .param_types = command_parameters46,
+    .num_args=7,
+    .flags=0,
+    .func=command_sos_filter_set_section
+}, {
+    // config_sos_filter oid=%c max_sections=%c
+    .encoded_msgid=94, // msgid=94
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_config_sos_filter
+}, {
+    // trigger_analog_query_state oid=%c
+    .encoded_msgid=95, // msgid=95
+    .num_params=1,
+    .param_types = command_parameters21,
+    .num_args=1,
+    .flags=0,
+    .func=command_trigger_analog_query_state
+}, {
+    // trigger_analog_home oid=%c trsync_oid=%c trigger_reason=%c error_reason=%c clock=%u monitor_ticks=%u monitor_max=%u
+    .encoded_msgid=96, // msgid=-32
+    .num_params=7,
+    .param_types = command_parameters47,
+    .num_args=7,
+    .flags=0,
+    .func=command_trigger_analog_home
+}, {
+    // trigger_analog_set_trigger oid=%c trigger_analog_type=%c trigger_value=%i
+    .encoded_msgid=97, // msgid=-31
+    .num_params=3,
+    .param_types = command_parameters48,
+    .num_args=3,
+    .flags=0,
+    .func=command_trigger_analog_set_trigger
+}, {
+    // trigger_analog_set_raw_range oid=%c raw_min=%i raw_max=%i
+    .encoded_msgid=98, // msgid=-30
+    .num_params=3,
+    .param_types = command_parameters49,
+    .num_args=3,
+    .flags=0,
+    .func=command_trigger_analog_set_raw_range
+}, {
+    // config_trigger_analog oid=%c sos_filter_oid=%c
+    .encoded_msgid=99, // msgid=-29
+    .num_params=2,
+    .param_types = command_parameters14,
+    .num_args=2,
+    .flags=0,
+    .func=command_config_trigger_analog
+},
+};
+
+const uint16_t command_index_size PROGMEM = ARRAY_SIZE(command_index);
+
+// version: ef41c50-dirty-20261018_101534-vm
+// build_versions: gcc: (Debian 12.2.0-14+deb12u1) 12.2.0 binutils: (GNU Binutils for Debian) 2.40
+
+const uint8_t command_identify_data[] PROGMEM = {
+    0x78, 0xda, 0x9d, 0x5a, 0xeb, 0x6f, 0xdb, 0x38,
+    0x12, 0xff, 0x57, 0x08, 0x03, 0x8b, 0xbb, 0xbd,
+    0x6d, 0x7a, 0x96, 0x65, 0xcb, 0x4e, 0x80, 0xfd,
+    0x90, 0x4d, 0xdc, 0xdd, 0x60, 0x9b, 0xa6, 0x6b,
+    0x67, 0x1f, 0xdf, 0x08, 0x45, 0xa2, 0x6d, 0x22,
+    0x7a, 0x78, 0x45, 0x29, 0x8f, 0x5b, 0xf4, 0x7f,
+    0xbf, 0x19, 0x0e, 0x5f, 0x92, 0xdc, 0x16, 0x68,
+    0x81, 0xd6, 0x12, 0x39, 0x1c, 0x92, 0xf3, 0xfc,
+    0xcd, 0xa8, 0xff, 0x4c, 0xd2, 0xe3, 0x71, 0x72,
+    0x31, 0xf9, 0xb5, 0x90, 0xc7, 0xa3, 0x68, 0x26,
+    0x6f, 0x26, 0x0f, 0x9d, 0x2c, 0x72, 0xfe, 0x24,
+    0x1a, 0x25, 0xeb, 0x4a, 0xc1, 0xd4, 0x3e, 0xcb,
+    0x2e, 0xd8, 0xbf, 0xaf, 0xc5, 0x83, 0x4c, 0x2b,
+    0x16, 0xcd, 0xde, 0xce, 0xde, 0x4e, 0xcf, 0xa2,
+    0xf9, 0x0f, 0xb9, 0x78, 0x88, 0x66, 0x5d, 0xf4,
+    0xbd, 0x19, 0x62, 0x0f, 0xb2, 0xea, 0x5a, 0x59,
+    0x28, 0xa0, 0xfd, 0xf9, 0xc3, 0xef, 0xec, 0x27,
+    0xf3, 0xca, 0x76, 0x75, 0xc3, 0x68, 0xf1, 0xf7,
+    0x6c, 0xf6, 0x76, 0x3e, 0x85, 0x2d, 0xb2, 0xba,
+    0x2c, 0xd3, 0x2a, 0x07, 0xe6, 0xff, 0x4c, 0xd2,
+    0x5c, 0x45, 0xb3, 0xd9, 0x94, 0xa7, 0x6d, 0x9b,
+    0x66, 0x07, 0xde, 0x36, 0x72, 0xbf, 0x17, 0x0d,
+    0x4f, 0xab, 0xb4, 0xa8, 0xf7, 0xac, 0x96, 0xf9,
+    0x8f, 0xdf, 0x65, 0xac, 0x3f, 0xca, 0x69, 0x74,
+    0x72, 0xb1, 0x8a, 0xde, 0xe8, 0xf5, 0x71, 0x54,
+    0x4e, 0x5f, 0xbe, 0x8d, 0xc3, 0x02, 0x38, 0x14,
+    0x45, 0x9d, 0xa5, 0xad, 0xc0, 0x41, 0xc5, 0xb2,
+    0xba, 0xab, 0x5a, 0x9a, 0x83, 0x29, 0xa2, 0x96,
+    0xd5, 0x37, 0x31, 0x8f, 0xe7, 0x28, 0xcd, 0xb6,
+    0x05, 0x31, 0xf2, 0x34, 0x7b, 0xb4, 0xd4, 0x7e,
+    0x87, 0x79, 0x12, 0x10, 0xe4, 0xb9, 0x25, 0x38,
+    0xd6, 0x4a, 0xff, 0xc8, 0xea, 0xc7, 0xef, 0x3a,
+    0x76, 0xec, 0x8a, 0x82, 0x77, 0x47, 0x5a, 0xb0,
+    0xf2, 0x0b, 0xfe, 0xee, 0x44, 0xf3, 0xea, 0x78,
+    0xc2, 0x15, 0x1e, 0x91, 0xba, 0x11, 0xaa, 0xe5,
+    0xad, 0xcc, 0x1e, 0x15, 0xbd, 0xb5, 0x4d, 0x5a,
+    0xa9, 0x52, 0xb6, 0xdc, 0xee, 0xca, 0x64, 0x05,
+    0xba, 0x35, 0xfb, 0x2f, 0x41, 0x17, 0x85, 0x48,
+    0x1b, 0xae, 0x0e, 0x5d, 0x9b, 0xd7, 0xcf, 0xd5,
+    0xe4, 0x62, 0x86, 0xea, 0xa9, 0x76, 0x72, 0xcf,
+    0x8d, 0x66, 0xec, 0x16, 0xea, 0x28, 0xcd, 0xcd,
+    0x58, 0x9e, 0xb6, 0x29, 0x6f, 0x44, 0x9a, 0xbf,
+    0x72, 0x3a, 0x24, 0x08, 0xab, 0xbf, 0x4e, 0x6b,
+    0xe4, 0xc4, 0xca, 0xec, 0x90, 0x56, 0x95, 0x28,
+    0xf0, 0xb1, 0xea, 0x4a, 0x6e, 0x5e, 0xd5, 0xe7,
+    0x98, 0x26, 0x01, 0xd3, 0x97, 0x22, 0x9e, 0x2f,
+    0xc6, 0x2c, 0x27, 0x17, 0xc9, 0xca, 0x53, 0x59,
+    0x7d, 0x39, 0x51, 0x1a, 0x4e, 0xb1, 0xe7, 0xf4,
+    0x50, 0xca, 0x28, 0x71, 0xb7, 0x7a, 0xe8, 0x14,
+    0xef, 0x3f, 0xf2, 0xf6, 0xf5, 0x28, 0x34, 0xe3,
+    0xe5, 0xdc, 0x2f, 0x22, 0xa1, 0xfb, 0x55, 0xf8,
+    0xca, 0x03, 0x4d, 0x9e, 0x3b, 0x52, 0x3d, 0x28,
+    0x9a, 0xfe, 0x09, 0x7a, 0x5a, 0x5c, 0xf8, 0xc3,
+    0xe4, 0x72, 0x2f, 0xdb, 0xb4, 0xe0, 0x75, 0xd7,
+    0x0e, 0x16, 0x3c, 0xa5, 0x45, 0x27, 0xb4, 0x5c,
+    0xc4, 0x2e, 0xed, 0x8a, 0x96, 0xbb, 0x81, 0x32,
+    0x7d, 0xe1, 0x79, 0xd7, 0xa4, 0x2d, 0xf8, 0xa7,
+    0xbe, 0x5c, 0xb4, 0x74, 0xfc, 0x04, 0x78, 0x55,
+    0x5b, 0x1f, 0x7b, 0xbc, 0xb2, 0xde, 0xe6, 0x33,
+    0x7f, 0xd2, 0x43, 0x3e, 0x9f, 0x2f, 0x57, 0x4e,
+    0x14, 0x8d, 0x32, 0x82, 0x67, 0xc2, 0x3e, 0xe4,
+    0x73, 0xf7, 0xb4, 0x70, 0x4f, 0x89, 0x7b, 0x5a,
+    0xba, 0x27, 0x51, 0xa4, 0xaf, 0xce, 0xec, 0x40,
+    0x25, 0xde, 0x1a, 0x0e, 0x2f, 0xcb, 0xc8, 0x59,
+    0xc2, 0x3e, 0x05, 0x57, 0x0a, 0x6c, 0x20, 0x87,
+    0x7b, 0x5b, 0x1e, 0x2a, 0x2b, 0x1e, 0x9d, 0xe6,
+    0x97, 0x5e, 0xa7, 0x85, 0x54, 0xb3, 0xfc, 0xf9,
+    0xeb, 0xfa, 0x62, 0x40, 0x08, 0xbc, 0xe5, 0x31,
+    0x50, 0x60, 0xe4, 0xb8, 0x54, 0xa2, 0x3e, 0xca,
+    0x17, 0x51, 0x0c, 0xa4, 0xac, 0x8d, 0x4e, 0xc9,
+    0xff, 0x01, 0xfd, 0xa1, 0x83, 0x10, 0xd6, 0x72,
+    0x94, 0x6e, 0xe0, 0x3f, 0x4a, 0xc0, 0x10, 0x1c,
+    0xda, 0xdf, 0x6d, 0xe1, 0xad, 0xe2, 0xf8, 0x5c,
+    0x9e, 0xd0, 0x5c, 0xf6, 0x0a, 0x3e, 0xe5, 0x79,
+    0x18, 0xbd, 0x1d, 0xba, 0xa1, 0x26, 0x61, 0x64,
+    0xa4, 0xca, 0xf9, 0xc2, 0x31, 0x57, 0xb5, 0xe2,
+    0x3b, 0x59, 0x04, 0xa6, 0x84, 0xd4, 0x4a, 0x64,
+    0x48, 0xac, 0xf4, 0xfd, 0xce, 0xfd, 0x51, 0xc0,
+    0x21, 0x86, 0xc7, 0xc0, 0xa0, 0xd3, 0xca, 0x27,
+    0xc1, 0x0f, 0x72, 0x7f, 0x20, 0x2b, 0x9d, 0x85,
+    0xf4, 0xe0, 0x2d, 0xfb, 0x42, 0x9c, 0x70, 0x52,
+    0x37, 0xe7, 0x25, 0xb9, 0x3a, 0xef, 0xad, 0xb4,
+    0xe1, 0xe2, 0xd4, 0x62, 0x33, 0xc5, 0x4b, 0xb5,
+    0xff, 0xf1, 0xbb, 0xff, 0x40, 0x8c, 0x8f, 0x97,
+    0xbd, 0xb5, 0xcf, 0xb2, 0x3d, 0xa0, 0xda, 0x33,
+    0xeb, 0x4d, 0x70, 0x2e, 0xaf, 0x27, 0xd5, 0x2e,
+    0xcf, 0x7d, 0xcc, 0xc9, 0xd4, 0x09, 0xeb, 0x60,
+    0x0a, 0x94, 0x6e, 0x1f, 0x5f, 0xab, 0x8c, 0xf7,
+    0xad, 0x8f, 0x65, 0x65, 0xce, 0x87, 0x06, 0xb9,
+    0x08, 0xce, 0xdf, 0x0a, 0xcc, 0x74, 0xee, 0xe8,
+    0xf0, 0xca, 0x8d, 0x9f, 0xe4, 0xb2, 0xb1, 0x8f,
+    0x14, 0x25, 0x35, 0xb1, 0xa7, 0xea, 0x0a, 0x25,
+    0x02, 0xa6, 0x33, 0xef, 0xc7, 0xed, 0x41, 0x34,
+    0x65, 0x0d, 0xae, 0x7f, 0x3c, 0x29, 0xd1, 0x70,
+    0xda, 0x0b, 0x35, 0xf1, 0xca, 0x6e, 0xcb, 0xac,
+    0x4b, 0x1b, 0x67, 0x49, 0xcd, 0x0b, 0x1f, 0xc5,
+    0x0d, 0xd6, 0xba, 0x41, 0xb4, 0xd3, 0x56, 0x96,
+    0x82, 0xae, 0xe6, 0x85, 0x77, 0x3a, 0x3b, 0x79,
+    0x43, 0x72, 0x21, 0xf3, 0x2c, 0x88, 0x02, 0x6d,
+    0x83, 0x42, 0x74, 0xba, 0x88, 0xe3, 0x37, 0x13,
+    0x48, 0xed, 0x1d, 0xb8, 0x4c, 0x0d, 0xc0, 0xe0,
+    0xdc, 0xbe, 0xc1, 0xd6, 0x7b, 0xed, 0x2e, 0xa4,
+    0xd4, 0x68, 0x6a, 0x27, 0x30, 0x64, 0xb3, 0xba,
+    0xc9, 0x45, 0x83, 0x9b, 0x41, 0x1a, 0x6b, 0x28,
+    0x28, 0xcd, 0x2c, 0xc1, 0x73, 0x23, 0x5b, 0x31,
+    0xa2, 0x40, 0xbf, 0x20, 0x42, 0x38, 0xbf, 0x28,
+    0x45, 0xb3, 0x17, 0x55, 0xf6, 0xca, 0x31, 0x7a,
+    0xc1, 0x21, 0x60, 0x88, 0x22, 0x19, 0x3f, 0xd4,
+    0xa5, 0x18, 0x65, 0x39, 0x95, 0x96, 0xc7, 0xd0,
+    0xc7, 0xcc, 0xbb, 0xcb, 0x71, 0xfd, 0x2c, 0x08,
+    0x47, 0xf7, 0xd1, 0x93, 0xae, 0xcb, 0x07, 0x99,
+    0x1b, 0x2e, 0xa1, 0xd0, 0x05, 0x31, 0x40, 0xae,
+    0xfc, 0xe6, 0x3a, 0xc7, 0xc2, 0x99, 0xd2, 0x56,
+    0x38, 0x01, 0xcd, 0xc0, 0x9c, 0x77, 0x12, 0x24,
+    0x0c, 0x51, 0x83, 0x93, 0x0c, 0x59, 0xd6, 0x64,
+    0x14, 0xf7, 0xde, 0x4c, 0xf6, 0x10, 0x30, 0xf4,
+    0x39, 0x41, 0x33, 0xe6, 0x4d, 0xd3, 0x40, 0x34,
+    0xa2, 0xd7, 0xee, 0x88, 0xaa, 0x03, 0xa3, 0x7f,
+    0x33, 0x31, 0x01, 0x18, 0x9c, 0xba, 0xca, 0x39,
+    0x98, 0xad, 0xcb, 0x2f, 0xf8, 0x4c, 0x72, 0x4e,
+    0xa2, 0x01, 0x19, 0xaa, 0x80, 0x05, 0x79, 0xd8,
+    0x90, 0x81, 0x3a, 0x74, 0xa4, 0xfd, 0x26, 0xa0,
+    0xb2, 0x84, 0xa3, 0xc9, 0x5c, 0x54, 0xad, 0xdc,
+    0x01, 0xa2, 0xd8, 0xed, 0x20, 0xe8, 0x69, 0x47,
+    0x72, 0xe9, 0x0d, 0x0e, 0x61, 0x03, 0xa8, 0x3e,
+    0x85, 0x13, 0xc6, 0x62, 0x16, 0xcc, 0x74, 0xc7,
+    0xdc, 0x0b, 0x8a, 0x50, 0xcc, 0xa1, 0x0b, 0x0e,
+    0xb9, 0x00, 0xb5, 0x92, 0x44, 0x07, 0xd0, 0xa2,
+    0xa7, 0x2e, 0x08, 0x36, 0xd3, 0x01, 0x9d, 0xd6,
+    0x40, 0xe7, 0xe3, 0xc5, 0xf2, 0x3c, 0x24, 0xe8,
+    0x61, 0x8d, 0x21, 0xab, 0xf9, 0x88, 0x72, 0xc8,
+    0x6c, 0x15, 0x9c, 0xaa, 0x87, 0x31, 0x06, 0xac,
+    0x92, 0xe5, 0x80, 0x6e, 0xc8, 0x28, 0x49, 0x1c,
+    0xc1, 0x10, 0x86, 0x7c, 0xa3, 0xe1, 0x3e, 0xbc,
+    0xb6, 0x02, 0x22, 0xa0, 0xb6, 0xcf, 0x63, 0xad,
+    0x41, 0x1b, 0x2b, 0xbd, 0x31, 0x9b, 0x04, 0xe2,
+    0xdf, 0x00, 0xeb, 0xed, 0x81, 0xd9, 0x41, 0x64,
+    0x8f, 0x01, 0x36, 0x89, 0x17, 0xf6, 0x5c, 0x7d,
+    0xe8, 0x33, 0xb8, 0xdf, 0x32, 0xee, 0x93, 0x8d,
+    0x84, 0x3e, 0xb3, 0xf3, 0x03, 0x84, 0xe3, 0x2e,
+    0x77, 0xac, 0x21, 0x56, 0x0d, 0xaf, 0x16, 0xc4,
+    0x60, 0x77, 0x8e, 0x1e, 0x26, 0x18, 0x1e, 0x23,
+    0xe9, 0x51, 0x8d, 0x4e, 0xe1, 0x98, 0xf4, 0x71,
+    0xc1, 0x90, 0xcb, 0xb4, 0x4f, 0x36, 0xd2, 0x95,
+    0xb3, 0xa0, 0x51, 0x22, 0xfc, 0x0c, 0x94, 0x46,
+    0xa7, 0x85, 0xbc, 0x27, 0x77, 0xa6, 0x38, 0x58,
+    0x59, 0x06, 0xa7, 0x42, 0xff, 0x67, 0x78, 0x04,
+    0xba, 0xeb, 0xa9, 0x8e, 0x5e, 0x20, 0xe5, 0x40,
+    0x50, 0xc9, 0x03, 0xcd, 0x25, 0x64, 0xbd, 0x9d,
+    0x38, 0x85, 0x13, 0xdd, 0x1e, 0x75, 0x88, 0x4e,
+    0xa2, 0x85, 0x5d, 0x32, 0x00, 0x27, 0x8e, 0xdc,
+    0x99, 0x0b, 0x84, 0x20, 0xc7, 0x1f, 0xf3, 0x9b,
+    0xa5, 0x94, 0xa8, 0x5c, 0x8a, 0xce, 0x36, 0x04,
+    0x80, 0x6d, 0x41, 0xd8, 0x86, 0x5f, 0x09, 0xf1,
+    0x6f, 0x11, 0x2e, 0xc2, 0x4c, 0xeb, 0x03, 0x92,
+    0x5f, 0x2a, 0x4f, 0x2e, 0xed, 0xed, 0xa7, 0x82,
+    0xd0, 0x30, 0x8b, 0x7b, 0x33, 0x86, 0x6b, 0x30,
+    0x0f, 0xc6, 0x47, 0x60, 0x4c, 0x6f, 0xaa, 0x2f,
+    0x33, 0xbc, 0x19, 0x50, 0x81, 0xd6, 0x91, 0x26,
+    0x94, 0xd6, 0x00, 0x4e, 0x83, 0x84, 0xe2, 0x11,
+    0x91, 0x96, 0x95, 0x86, 0x6d, 0x8e, 0x67, 0x0f,
+    0xc3, 0xc1, 0xa2, 0x84, 0x16, 0x55, 0xe2, 0xc5,
+    0x1c, 0x01, 0xb0, 0x82, 0x0b, 0xc3, 0xb2, 0xa1,
+    0xcc, 0x10, 0x11, 0x91, 0x95, 0xfc, 0x57, 0xf0,
+    0x20, 0xc8, 0x1f, 0x8f, 0xe2, 0xb3, 0x33, 0xae,
+    0x25, 0xc8, 0x66, 0x39, 0x57, 0x21, 0xde, 0x03,
+    0x89, 0x8a, 0xdd, 0x8e, 0xef, 0x9a, 0x34, 0xe3,
+    0x80, 0x00, 0x0c, 0x04, 0x9c, 0x8e, 0x58, 0x50,
+    0x00, 0xe7, 0x2a, 0x4b, 0xfd, 0x7d, 0x6c, 0x50,
+    0x97, 0x4c, 0x0f, 0xbb, 0x87, 0x1e, 0x37, 0x96,
+    0x76, 0x6d, 0xcd, 0x2d, 0x29, 0x32, 0x8f, 0x46,
+    0xcc, 0xcd, 0x79, 0x1c, 0xb6, 0xa0, 0x57, 0x2e,
+    0xf3, 0x17, 0x03, 0x35, 0xa6, 0x9a, 0x77, 0xad,
+    0x22, 0xf3, 0x3b, 0x33, 0xbf, 0xb1, 0xf9, 0x9d,
+    0xc3, 0x2f, 0x70, 0x1e, 0xdf, 0x3c, 0xcc, 0xb2,
+    0x23, 0xbe, 0x38, 0x47, 0x9c, 0xf1, 0x29, 0x22,
+    0x1e, 0x60, 0x13, 0x01, 0x54, 0xc5, 0x42, 0x77,
+    0xe7, 0xa3, 0x92, 0xb7, 0x9d, 0xd5, 0x92, 0xe8,
+    0x82, 0xc4, 0x15, 0xcc, 0xc6, 0x2b, 0x3b, 0xdb,
+    0x42, 0x95, 0xa7, 0x42, 0xf0, 0x06, 0xaf, 0xda,
+    0x37, 0xeb, 0x5c, 0xfb, 0x28, 0xc0, 0x74, 0x42,
+    0x5c, 0xf3, 0xa9, 0x5f, 0xa2, 0x9e, 0xc3, 0x55,
+    0xa5, 0x54, 0xb5, 0x05, 0x69, 0x65, 0xad, 0xe4,
+    0x29, 0xf4, 0x6a, 0xd9, 0x0d, 0xd1, 0x64, 0x12,
+    0x13, 0xd7, 0xcf, 0x5f, 0x24, 0x86, 0xa0, 0x45,
+    0xf8, 0xf8, 0x4b, 0x88, 0x61, 0xb1, 0xea, 0x53,
+    0x9d, 0x06, 0x0c, 0x0b, 0x14, 0x0a, 0x21, 0x61,
+    0x8e, 0xa8, 0x04, 0xb2, 0xb5, 0x0c, 0x14, 0x0b,
+    0x16, 0x7f, 0xee, 0x09, 0x34, 0x16, 0xc2, 0x30,
+    0x43, 0xf0, 0xc1, 0xa3, 0x89, 0x00, 0x4a, 0xc1,
+    0x0a, 0xd8, 0xd8, 0xe0, 0xd8, 0x9e, 0xac, 0x35,
+    0xfe, 0xc3, 0x5d, 0x19, 0x42, 0x45, 0x82, 0x0d,
+    0x20, 0xc1, 0x01, 0x16, 0x09, 0x71, 0xde, 0x57,
+    0x30, 0x1a, 0x13, 0x4d, 0x53, 0x87, 0xef, 0x2e,
+    0xb6, 0x95, 0x75, 0x25, 0x5b, 0x98, 0xf2, 0x11,
+    0xd7, 0x0c, 0x40, 0x7c, 0xd5, 0x42, 0x3e, 0x8b,
+    0x67, 0xa3, 0x9d, 0x4f, 0x81, 0xbc, 0xf3, 0xc5,
+    0x88, 0x0c, 0xb5, 0xdd, 0xa4, 0xcf, 0x5c, 0x27,
+    0x59, 0x97, 0x76, 0x60, 0xa0, 0x44, 0xbd, 0x4a,
+    0x7a, 0xc4, 0x6d, 0x24, 0x6e, 0x33, 0x3d, 0xb9,
+    0x7e, 0x24, 0xc0, 0x1e, 0x85, 0x2d, 0x64, 0xed,
+    0xb0, 0x89, 0x14, 0x9a, 0x5f, 0x84, 0xfc, 0xb4,
+    0x54, 0x34, 0x1f, 0x48, 0x46, 0x27, 0x62, 0x3b,
+    0x98, 0x48, 0x40, 0xd7, 0x86, 0x05, 0x85, 0xc6,
+    0x0f, 0x3c, 0xc8, 0x4b, 0xfa, 0xdd, 0xc9, 0x49,
+    0xbc, 0x1c, 0x65, 0x23, 0x42, 0x18, 0x4c, 0x82,
+    0xd2, 0x9c, 0x06, 0xa7, 0x0e, 0x89, 0xe0, 0x9a,
+    0x84, 0xfa, 0x4e, 0x65, 0xa8, 0x20, 0xe6, 0xce,
+    0x3f, 0xd9, 0x7a, 0x03, 0x7b, 0x7e, 0x57, 0xef,
+    0xef, 0xae, 0x7e, 0xe5, 0xef, 0x36, 0xeb, 0xdf,
+    0x30, 0x66, 0xd3, 0x9f, 0x37, 0x93, 0xcd, 0xfa,
+    0x6a, 0x7d, 0xf3, 0xc7, 0x9a, 0xff, 0x79, 0xf3,
+    0xe1, 0xfa, 0xee, 0x4f, 0xb4, 0x40, 0x38, 0xc2,
+    0x76, 0xbd, 0xb9, 0xb9, 0x7c, 0xcf, 0x7f, 0xba,
+    0xfc, 0xfd, 0x1a, 0x53, 0x0f, 0x51, 0x6e, 0xef,
+    0x2f, 0xef, 0xb7, 0x7c, 0xfb, 0xfb, 0xed, 0xf6,
+    0x37, 0x98, 0xd9, 0xae, 0x71, 0x26, 0xc1, 0xe1,
+    0xf5, 0xc7, 0x8f, 0xeb, 0x0d, 0xc7, 0x5f, 0xfe,
+    0xd3, 0xdd, 0xfd, 0x2f, 0x7c, 0x7d, 0xfd, 0x33,
+    0x4c, 0x46, 0x9f, 0x10, 0xd1, 0x77, 0x50, 0x63,
+    0xe8, 0x42, 0xdb, 0xb5, 0x1d, 0x09, 0x0e, 0x6a,
+    0x63, 0xba, 0xc0, 0xb1, 0xed, 0xfa, 0xc3, 0xf6,
+    0x6e, 0xc3, 0xd7, 0x9b, 0x0d, 0xfc, 0x7b, 0xb5,
+    0xb9, 0xd2, 0xb8, 0xb7, 0x37, 0xb8, 0x59, 0x6f,
+    0xd7, 0xf7, 0xb0, 0xdb, 0x27, 0x6c, 0xc3, 0xf9,
+    0xee, 0x03, 0x2e, 0x96, 0x33, 0xc2, 0xc9, 0xe0,
+    0xc2, 0x93, 0x8b, 0x29, 0x10, 0xf4, 0xda, 0x11,
+    0x48, 0xf1, 0xfe, 0x66, 0x3b, 0xbb, 0x86, 0x7b,
+    0xc1, 0x05, 0xe0, 0x31, 0xbe, 0xfe, 0x85, 0x4e,
+    0xd6, 0xaf, 0xb6, 0xf5, 0xd9, 0xa2, 0x38, 0x8e,
+    0x35, 0x5d, 0xaa, 0x16, 0xd3, 0xf9, 0x32, 0xd7,
+    0x8c, 0xcb, 0x36, 0x59, 0x45, 0x89, 0xae, 0x8d,
+    0xf0, 0x71, 0x96, 0x28, 0x5d, 0x43, 0xb4, 0x85,
+    0x58, 0x4c, 0xa3, 0xd9, 0x03, 0x9d, 0x0a, 0xad,
+    0x58, 0xa2, 0xee, 0x1b, 0x28, 0xd7, 0x20, 0x7a,
+    0x22, 0xbb, 0xcb, 0xeb, 0x2b, 0xa6, 0xb5, 0xb2,
+    0x23, 0x80, 0x48, 0x25, 0xcc, 0x65, 0xa1, 0x7b,
+    0x6d, 0xcc, 0x96, 0x32, 0x39, 0x65, 0xc6, 0xab,
+    0xb4, 0x62, 0x55, 0xdd, 0x42, 0x00, 0x86, 0xbf,
+    0xf5, 0x0e, 0x92, 0xd8, 0x73, 0x49, 0x19, 0x8c,
+    0x69, 0x63, 0x61, 0xcf, 0x07, 0x09, 0xcf, 0xa4,
+    0x74, 0xc5, 0x8e, 0xe0, 0xe7, 0xb0, 0x13, 0xa5,
+    0x5e, 0x58, 0xfb, 0xaf, 0x16, 0xb3, 0x3d, 0x54,
+    0xe8, 0x7b, 0xe0, 0x0a, 0x65, 0x6f, 0xda, 0x32,
+    0xa9, 0x58, 0x6a, 0xf6, 0xa2, 0xe4, 0x46, 0x10,
+    0xc2, 0x10, 0x2b, 0x24, 0x45, 0x83, 0xa1, 0x42,
+    0x90, 0x46, 0x75, 0xa6, 0xd7, 0x88, 0x0b, 0xb6,
+    0x13, 0x15, 0xb3, 0x25, 0xbb, 0x5b, 0x0f, 0x86,
+    0x71, 0x45, 0x3d, 0x64, 0x76, 0x4c, 0x1b, 0x05,
+    0x53, 0x5a, 0x8b, 0xba, 0xc6, 0xb2, 0x13, 0x8d,
+    0x00, 0xc7, 0x56, 0xad, 0xee, 0xe3, 0xbe, 0xa3,
+    0x3e, 0x8a, 0x4d, 0x5e, 0xb2, 0xca, 0xc5, 0x0b,
+    0x2b, 0xd2, 0x06, 0xad, 0x1a, 0x0e, 0x59, 0xf5,
+    0x5a, 0x2b, 0xd4, 0x17, 0xfd, 0xe5, 0x2f, 0xc4,
+    0xa8, 0xd8, 0xb0, 0xfa, 0xaf, 0x69, 0x58, 0xf5,
+    0x84, 0xc8, 0xa2, 0xb3, 0x39, 0x25, 0xf0, 0x1b,
+    0x82, 0x6d, 0xcc, 0x97, 0x22, 0xb6, 0xab, 0xc9,
+    0xc8, 0xe2, 0x4d, 0x7f, 0x87, 0xe0, 0x96, 0xa3,
+    0x76, 0x25, 0xc2, 0x10, 0xe4, 0x53, 0x5f, 0xc1,
+    0xd2, 0xd9, 0xc6, 0xa3, 0xef, 0xe4, 0x12, 0xb0,
+    0x22, 0x57, 0xb7, 0x54, 0xa6, 0xa1, 0xae, 0x4b,
+    0x4e, 0x3f, 0x06, 0x64, 0x28, 0x9e, 0xb4, 0x14,
+    0x70, 0x79, 0xc2, 0x58, 0x76, 0xb2, 0xac, 0x01,
+    0x64, 0x18, 0x09, 0x31, 0xec, 0x7f, 0xa1, 0x8f,
+    0xfa, 0x69, 0xd7, 0x2d, 0x73, 0xfd, 0x31, 0x6a,
+    0xa1, 0x8e, 0xe6, 0x4d, 0xc9, 0xe7, 0xf6, 0x8f,
+    0x83, 0x03, 0x80, 0x52, 0x19, 0x99, 0x34, 0xf6,
+    0x02, 0xec, 0x28, 0x36, 0xaa, 0x6c, 0x24, 0xc0,
+    0x52, 0x3b, 0x18, 0x37, 0x38, 0x1c, 0x9d, 0xc6,
+    0x2c, 0x9c, 0x07, 0x7b, 0xf6, 0x70, 0x76, 0x40,
+    0x83, 0x09, 0xfc, 0x36, 0x7d, 0x41, 0xcd, 0xac,
+    0xac, 0xb8, 0xa8, 0x8d, 0x71, 0x2b, 0x94, 0x4a,
+    0x41, 0x55, 0xa2, 0xca, 0x20, 0xe7, 0x5a, 0x13,
+    0x01, 0x96, 0xb7, 0x52, 0x29, 0x01, 0x5b, 0x42,
+    0xa5, 0x94, 0x77, 0x05, 0x36, 0x36, 0x60, 0x31,
+    0x42, 0x3b, 0x66, 0xa2, 0x98, 0x56, 0xb5, 0x78,
+    0x12, 0x28, 0x67, 0x44, 0x75, 0x9f, 0x5f, 0x70,
+    0x48, 0x9b, 0x5c, 0xfb, 0x88, 0xa1, 0xc6, 0x88,
+    0x78, 0x8b, 0xc2, 0xd5, 0x68, 0x96, 0xc1, 0x53,
+    0xb3, 0x2b, 0xea, 0x67, 0x02, 0xe6, 0x1b, 0x61,
+    0x38, 0x00, 0x2f, 0xb4, 0xee, 0x06, 0x2c, 0x11,
+    0xef, 0x05, 0x5a, 0x42, 0x43, 0xc5, 0xee, 0xfe,
+    0xd6, 0x11, 0x8c, 0x8e, 0xc2, 0x9e, 0x65, 0x51,
+    0x40, 0xa4, 0xce, 0x04, 0xcc, 0x86, 0x9d, 0x43,
+    0x4a, 0xd6, 0x7e, 0xa5, 0x3b, 0xce, 0x17, 0x56,
+    0x60, 0x03, 0x68, 0x0b, 0x4e, 0x46, 0x02, 0xd3,
+    0x07, 0x40, 0x0a, 0x59, 0x76, 0xa5, 0x1d, 0xb3,
+    0x76, 0x86, 0x51, 0xd8, 0xf6, 0xfb, 0xf4, 0xd7,
+    0x02, 0x60, 0xa6, 0xdd, 0x52, 0xc7, 0x89, 0xf0,
+    0xc3, 0xc1, 0xd6, 0xf8, 0x69, 0x5b, 0xd7, 0x6c,
+    0x97, 0xea, 0xdb, 0xd1, 0xcd, 0x10, 0xf8, 0xdf,
+    0x87, 0xfa, 0xc3, 0x78, 0x00, 0x84, 0xba, 0x1f,
+    0x4a, 0x1d, 0xc2, 0x7b, 0x2d, 0x0f, 0x5c, 0x09,
+    0x49, 0x4a, 0x09, 0x1d, 0xe7, 0xf4, 0x97, 0x19,
+    0x08, 0xa2, 0x5d, 0xf5, 0x08, 0xa4, 0x10, 0x77,
+    0x72, 0x6a, 0x76, 0x07, 0xe3, 0xca, 0x4f, 0x24,
+    0xf8, 0xbd, 0x06, 0x0d, 0x08, 0xc0, 0x87, 0xaa,
+    0x1b, 0x6d, 0xde, 0x90, 0xd4, 0xc0, 0x0d, 0x15,
+    0x42, 0x71, 0x6a, 0xae, 0x62, 0xd8, 0x46, 0xbb,
+    0x61, 0x10, 0xaf, 0x59, 0x57, 0xa9, 0xee, 0x88,
+    0x3e, 0x87, 0xeb, 0xb1, 0x09, 0xe9, 0x67, 0xc9,
+    0xe8, 0x08, 0xeb, 0xb9, 0x51, 0xb4, 0xdd, 0xfe,
+    0x1a, 0xdf, 0x50, 0xa5, 0x98, 0x55, 0x57, 0x05,
+    0x84, 0xb9, 0x27, 0x38, 0x52, 0xfa, 0x50, 0xd8,
+    0xe8, 0xe5, 0x44, 0x04, 0x32, 0x47, 0xf4, 0x57,
+    0xb0, 0xfe, 0x1e, 0x88, 0xeb, 0xf4, 0xb7, 0x27,
+    0x17, 0x27, 0xcd, 0x17, 0xa9, 0x9c, 0xfa, 0x6c,
+    0x0a, 0x3b, 0x33, 0x18, 0x80, 0xc8, 0x66, 0x00,
+    0xb7, 0xeb, 0x0b, 0xcf, 0x1d, 0xdc, 0xd2, 0x6e,
+    0xaa, 0x65, 0xa7, 0x63, 0x1a, 0x7d, 0x79, 0x3a,
+    0x91, 0x97, 0x51, 0x61, 0xe4, 0x4c, 0xd8, 0x84,
+    0x35, 0xe1, 0x94, 0x2c, 0x15, 0xe1, 0x1b, 0xe4,
+    0x8f, 0x51, 0xa3, 0x12, 0x13, 0xc8, 0xed, 0xe5,
+    0x5f, 0x71, 0xb4, 0x5a, 0x2c, 0x74, 0x4a, 0x32,
+    0x2f, 0x89, 0xce, 0x49, 0xf4, 0x92, 0x2c, 0xb4,
+    0xf6, 0xe1, 0x25, 0x49, 0x96, 0xf0, 0x1c, 0x7f,
+    0x1a, 0x81, 0x1f, 0x9f, 0x64, 0x6f, 0xef, 0x3e,
+    0xdc, 0xdc, 0xdf, 0x6d, 0xf4, 0x8a, 0xbb, 0x3f,
+    0xd6, 0x9b, 0x77, 0xef, 0x75, 0xae, 0x07, 0xe7,
+    0xb8, 0xfc, 0x93, 0x6f, 0x2e, 0x3f, 0x60, 0xc2,
+    0x9e, 0xba, 0xb4, 0xbb, 0xfd, 0xb8, 0xbe, 0xba,
+    0x79, 0x77, 0x73, 0x75, 0x92, 0xa9, 0xcb, 0x97,
+    0x0f, 0x8a, 0xe3, 0xad, 0xb1, 0x25, 0x29, 0xa1,
+    0x42, 0x3a, 0x8a, 0xf4, 0x91, 0xef, 0x5b, 0xbd,
+    0x05, 0xfe, 0x44, 0x9f, 0x74, 0x3a, 0xce, 0xc0,
+    0x2c, 0x80, 0x6a, 0x82, 0x5f, 0x27, 0x7f, 0xfe,
+    0xf8, 0xfe, 0x29, 0x9e, 0xe8, 0x9a, 0xf2, 0x08,
+    0xf1, 0x42, 0x10, 0x26, 0x70, 0x5f, 0xfb, 0x7a,
+    0xb5, 0x88, 0xae, 0xf9, 0xfa, 0xe5, 0xb3, 0x81,
+    0xda, 0x67, 0x51, 0xf0, 0x01, 0xaf, 0xb7, 0x26,
+    0x0d, 0x3a, 0x30, 0x54, 0xb3, 0xd8, 0x15, 0xd8,
+    0xb2, 0xd7, 0xd5, 0xab, 0x07, 0x6d, 0x67, 0x18,
+    0x99, 0x4d, 0x27, 0x11, 0x41, 0x83, 0x7e, 0xd2,
+    0xb8, 0x4e, 0xb7, 0x15, 0x71, 0xcc, 0xda, 0x90,
+    0x2e, 0x32, 0x20, 0xa8, 0x70, 0x57, 0x5d, 0xe3,
+    0x72, 0x6d, 0x85, 0xba, 0x27, 0xf3, 0xa5, 0x93,
+    0x9b, 0x25, 0xe6, 0x81, 0x07, 0xfb, 0x63, 0xe6,
+    0xb5, 0xcd, 0x5c, 0x05, 0x1e, 0xe9, 0x7a, 0xb3,
+    0x67, 0x98, 0xd6, 0x6d, 0x33, 0xb4, 0xc7, 0x1a,
+    0xe0, 0x3a, 0x84, 0xc1, 0xf1, 0x26, 0x61, 0xaf,
+    0x15, 0x39, 0xaf, 0x7c, 0x67, 0x91, 0x5b, 0x61,
+    0x07, 0x2d, 0x46, 0x2a, 0x48, 0xde, 0xa2, 0x68,
+    0x60, 0xa7, 0xe0, 0xa2, 0x6c, 0x88, 0x64, 0xec,
+    0x5d, 0x97, 0x41, 0xc3, 0xd1, 0x9c, 0xd6, 0x96,
+    0x6c, 0x5d, 0x96, 0x41, 0xc4, 0x37, 0x1b, 0x83,
+    0x4c, 0x60, 0xb3, 0xb0, 0x65, 0x7d, 0x46, 0xf5,
+    0x39, 0xc6, 0x06, 0xa8, 0xd9, 0xa0, 0x20, 0x0b,
+    0x2b, 0x23, 0x85, 0xb9, 0xb0, 0xca, 0xc4, 0xa0,
+    0x65, 0x79, 0xb6, 0xec, 0x2f, 0xe9, 0xb5, 0x91,
+    0x7c, 0xdd, 0x61, 0x3a, 0x41, 0x16, 0x4d, 0x53,
+    0x97, 0x20, 0xe4, 0xf8, 0xd0, 0xed, 0xa0, 0xa4,
+    0x13, 0x39, 0xb5, 0xc9, 0x00, 0xf4, 0x40, 0x74,
+    0xe0, 0x36, 0x39, 0x28, 0x73, 0x37, 0x2c, 0xdc,
+    0x7c, 0xa0, 0xb5, 0x1d, 0xc3, 0xcf, 0xc8, 0x21,
+    0x39, 0x55, 0xfc, 0x06, 0x22, 0x1e, 0x37, 0xa2,
+    0xf4, 0x84, 0xb9, 0xd6, 0x79, 0xbf, 0xd6, 0x1c,
+    0xad, 0x1b, 0x90, 0x63, 0xf2, 0xd2, 0xf5, 0x84,
+    0xc6, 0x7a, 0x67, 0xb3, 0x15, 0x21, 0x4d, 0xe5,
+    0x6d, 0x4a, 0x75, 0xa5, 0xf9, 0x51, 0x7f, 0x1b,
+    0xd3, 0x59, 0xf8, 0x02, 0x72, 0x50, 0x5d, 0x52,
+    0x6f, 0x18, 0xeb, 0x1a, 0x4c, 0x5c, 0xbd, 0x98,
+    0xd3, 0x57, 0xe9, 0x09, 0xd7, 0xc3, 0x07, 0x9d,
+    0x36, 0x8c, 0x9e, 0xa7, 0xbe, 0xe8, 0x1c, 0x5f,
+    0x02, 0xcb, 0x4d, 0xba, 0x40, 0x3c, 0xae, 0xc7,
+    0x4e, 0x9b, 0x33, 0x3d, 0x85, 0xde, 0x91, 0x84,
+    0x25, 0x95, 0x5f, 0x92, 0xa5, 0xae, 0x20, 0x3e,
+    0x5d, 0xa5, 0x86, 0x0e, 0xb6, 0xc4, 0x78, 0xac,
+    0x01, 0x2d, 0x7d, 0x8c, 0xeb, 0x7a, 0xee, 0x8f,
+    0xd5, 0x91, 0xf9, 0x0f, 0x17, 0x10, 0x9f, 0xc4,
+    0x6e, 0x1e, 0x65, 0x8b, 0xe9, 0x59, 0x2e, 0x9b,
+    0xf6, 0x15, 0x3c, 0x70, 0x96, 0x44, 0xd3, 0x68,
+    0xc5, 0xe1, 0x9f, 0x45, 0x3c, 0x3f, 0x7b, 0x2a,
+    0x27, 0x9f, 0xfe, 0x0f, 0x30, 0x86, 0x79, 0xae,
+};
+
+// Identify size = 2984 (8629 uncompressed)
+const uint32_t command_identify_size PROGMEM
+    = ARRAY_SIZE(command_identify_data);
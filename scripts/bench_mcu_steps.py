@@ -0,0 +1,246 @@
+#!/usr/bin/env python
+# Benchmark a linux mcu by replaying the step commands of a batch mode output
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, collections, logging
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+import reactor, serialhdl, clocksync, msgproto
+
+START_DELAY = 0.500
+RESET_DELAY = 0.005
+
+
+######################################################################
+# Batch mode output parsing
+######################################################################
+
+# Each replayed command is stored as (msgformat, params, moves, reset_oid)
+# where moves is a list of (oid, first_clock, last_clock)
+
+class StepperState:
+    def __init__(self):
+        self.last_clock = 0
+        self.predict_interval = 0
+    def add_move(self, interval, count, add):
+        first_clock = self.last_clock + interval
+        self.last_clock += count * interval + add * count * (count - 1) // 2
+        self.predict_interval = (interval + add * count) & 0xffffffff
+        return first_clock, self.last_clock
+
+def parse_queue_steps(data, is_delta, steppers):
+    # Decode the entries of a queue_steps (or queue_steps_delta) buffer
+    pt_uint, pt_int = msgproto.PT_uint32(), msgproto.PT_int32()
+    moves = []
+    pos = 0
+    while pos < len(data):
+        oid, pos = pt_uint.parse(data, pos)
+        interval, pos = (pt_int if is_delta else pt_uint).parse(data, pos)
+        count, pos = pt_uint.parse(data, pos)
+        add, pos = pt_int.parse(data, pos)
+        ss = steppers[oid]
+        if is_delta:
+            interval = (interval + ss.predict_interval) & 0xffffffff
+        moves.append((oid,) + ss.add_move(interval, count, add))
+    return moves
+
+def read_output(dict_filename, data_filename):
+    f = open(dict_filename, 'rb')
+    dictionary = f.read()
+    f.close()
+    mp = msgproto.MessageParser()
+    mp.process_identify(dictionary, decompress=False)
+    f = open(data_filename, 'rb')
+    data = f.read()
+    f.close()
+    config_cmds = []
+    step_cmds = []
+    steppers = {}
+    while data:
+        l = mp.check_packet(data)
+        if l <= 0:
+            raise Exception("Invalid data in batch mode output")
+        pos = msgproto.MESSAGE_HEADER_SIZE
+        while pos < l - msgproto.MESSAGE_TRAILER_SIZE:
+            msgid, param_pos = mp.msgid_parser.parse(data, pos)
+            mf = mp.messages_by_id[msgid]
+            params, pos = mf.parse(data, pos)
+            name = mf.name
+            cmd = (mf.msgformat, params, [], None)
+            if name == 'allocate_oids':
+                config_cmds.append(cmd)
+            elif name == 'config_stepper':
+                config_cmds.append(cmd)
+                oid = params['oid']
+                steppers[oid] = StepperState()
+                # Steps are relative to clock zero until the first reset
+                step_cmds.append(("reset_step_clock oid=%c clock=%u",
+                                  {'oid': oid, 'clock': 0}, [], oid))
+            elif name == 'reset_step_clock':
+                ss = steppers[params['oid']]
+                # Extend the 32bit clock using the last known step time
+                clock = params['clock']
+                ss.last_clock += (clock - ss.last_clock) & 0xffffffff
+                ss.predict_interval = 0
+                step_cmds.append(cmd[:3] + (params['oid'],))
+            elif name == 'set_next_step_dir':
+                step_cmds.append(cmd)
+            elif name in ('queue_step', 'queue_step_delta'):
+                ss = steppers[params['oid']]
+                interval = params['interval']
+                if name == 'queue_step_delta':
+                    interval = (interval + ss.predict_interval) & 0xffffffff
+                cmd[2].append((params['oid'],) + ss.add_move(
+                    interval, params['count'], params['add']))
+                step_cmds.append(cmd)
+            elif name in ('queue_steps', 'queue_steps_delta'):
+                cmd[2].extend(parse_queue_steps(
+                    params['data'], name == 'queue_steps_delta', steppers))
+                step_cmds.append(cmd)
+        data = data[l:]
+    return config_cmds, step_cmds
+
+
+######################################################################
+# Replay
+######################################################################
+
+def read_cpu_time(pid):
+    # Return the cpu time (in seconds) used by the given process
+    f = open("/proc/%d/schedstat" % (pid,), 'r')
+    data = f.read()
+    f.close()
+    return int(data.split()[0]) * .000000001
+
+class MoveQueue:
+    # Track the mcu move queue space like steppersync does
+    def __init__(self, size, per_stepper):
+        self.size = size
+        self.per_stepper = per_stepper
+        self.queues = {}
+    def add_move(self, oid, last_clock):
+        # Returns the clock that a slot for the move becomes available
+        mq = self.queues.setdefault(oid if self.per_stepper else None,
+                                    collections.deque())
+        min_clock = 0
+        if len(mq) >= self.size:
+            min_clock = mq.popleft()
+        mq.append(last_clock)
+        return min_clock
+
+class Replay:
+    def __init__(self, serial, options):
+        self.serial = serial
+        self.options = options
+        self.reactor = serial.get_reactor()
+        self.clocksync = clocksync.ClockSync(self.reactor)
+        self.results = None
+        self.shutdown_reason = None
+    def _handle_shutdown(self, params):
+        if self.shutdown_reason is None:
+            self.shutdown_reason = params['static_string_id']
+    def send(self, msgformat, params, minclock=0, reqclock=0):
+        mp = self.serial.get_msgparser()
+        cmd = mp.lookup_command(msgformat).encode_by_name(**params)
+        self.serial.raw_send(cmd, minclock, reqclock,
+                             self.serial.get_default_command_queue())
+    def run(self, config_cmds, step_cmds):
+        options = self.options
+        self.serial.connect_pipe(options.device)
+        self.serial.register_response((lambda params: None), 'stats')
+        self.serial.register_response(self._handle_shutdown, 'shutdown')
+        self.clocksync.connect(self.serial)
+        mp = self.serial.get_msgparser()
+        mcu_freq = mp.get_constant_float('CLOCK_FREQ')
+        params = self.serial.send_with_response('get_config', 'config')
+        if params['is_config'] or params['is_shutdown']:
+            raise Exception("The mcu must be restarted before a replay")
+        ring_size = mp.get_constant_int('STEPPER_MOVE_QUEUE', 0)
+        for msgformat, params, moves, reset_oid in config_cmds:
+            self.send(msgformat, params)
+        self.serial.send('finalize_config crc=0')
+        params = self.serial.send_with_response('get_config', 'config')
+        if ring_size:
+            move_queue = MoveQueue(ring_size, True)
+        else:
+            move_queue = MoveQueue(params['move_count'], False)
+        # Rebase the replayed clocks to the current mcu clock
+        first_clock = min([m[1] for cmd in step_cmds for m in cmd[2]])
+        start_clock = self.clocksync.get_clock(self.reactor.monotonic())
+        offset = start_clock + int(START_DELAY * mcu_freq) - first_clock
+        lead_ticks = int(options.lead_time * mcu_freq)
+        last_clocks = {}
+        end_clock = move_count = 0
+        cpu_start = read_cpu_time(options.pid)
+        for msgformat, params, moves, reset_oid in step_cmds:
+            if reset_oid is not None:
+                # The stepper must be idle before its clock is reset
+                params = dict(params)
+                params['clock'] = (params['clock'] + offset) & 0xffffffff
+                minclock = (last_clocks.get(reset_oid, 0)
+                            + int(RESET_DELAY * mcu_freq))
+                self.send(msgformat, params, minclock)
+                continue
+            if not moves:
+                self.send(msgformat, params)
+                continue
+            minclock = 0
+            reqclock = min([m[1] for m in moves]) + offset
+            for oid, move_first_clock, move_last_clock in moves:
+                move_last_clock += offset
+                minclock = max(minclock, move_queue.add_move(
+                    oid, move_last_clock))
+                last_clocks[oid] = move_last_clock
+                end_clock = max(end_clock, move_last_clock)
+                move_count += 1
+            minclock = max(minclock, reqclock - lead_ticks)
+            self.send(msgformat, params, minclock, reqclock)
+        # Wait for the replay to complete
+        end_time = self.clocksync.estimate_clock_systime(end_clock)
+        self.reactor.pause(end_time + START_DELAY)
+        cpu_time = read_cpu_time(options.pid) - cpu_start
+        params = self.serial.send_with_response('get_config', 'config')
+        if params['is_shutdown']:
+            raise Exception("The mcu shutdown during the replay: %s"
+                            % (self.shutdown_reason,))
+        run_time = float(end_clock - start_clock) / mcu_freq
+        self.results = (move_count, run_time, cpu_time)
+
+def main():
+    usage = "%prog [options] <dictionary> <output file> <device>"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-p", "--pid", type="int", dest="pid",
+                    help="process id of the linux mcu")
+    opts.add_option("-l", "--lead-time", type="float", dest="lead_time",
+                    default=0.250, help="time commands are sent in advance (s)")
+    options, args = opts.parse_args()
+    if len(args) != 3 or options.pid is None:
+        opts.error("Incorrect number of arguments")
+    dict_filename, data_filename, options.device = args
+    logging.basicConfig(level=logging.WARNING)
+
+    config_cmds, step_cmds = read_output(dict_filename, data_filename)
+    r = reactor.Reactor()
+    serial = serialhdl.SerialReader(r)
+    replay = Replay(serial, options)
+    def run(eventtime):
+        try:
+            replay.run(config_cmds, step_cmds)
+        finally:
+            serial.disconnect()
+            r.end()
+    r.register_callback(run)
+    r.run()
+    if replay.results is None:
+        sys.exit(-1)
+    move_count, run_time, cpu_time = replay.results
+    print("%10s %10s %12s %12s %10s" % (
+        "moves", "time", "moves/second", "mcu cpu", "us/move"))
+    print("%10d %10.3f %12.0f %12.3f %10.3f" % (
+        move_count, run_time, move_count / run_time, cpu_time,
+        cpu_time * 1000000. / move_count))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+# Benchmark message parsing using a captured serial data dump
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, time
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+import msgproto, chelper
+
+def read_blocks(mp, data_filename):
+    f = open(data_filename, 'rb')
+    data = bytearray(f.read())
+    f.close()
+    blocks = []
+    while 1:
+        l = mp.check_packet(data)
+        if l == 0:
+            break
+        if l < 0:
+            data = data[-l:]
+            continue
+        blocks.append(data[:l])
+        data = data[l:]
+    return blocks
+
+# Parse all messages in all blocks using the python parser
+def parse_python(mp, blocks):
+    out = []
+    for block in blocks:
+        s = list(block)
+        pos = msgproto.MESSAGE_HEADER_SIZE
+        end = len(s) - msgproto.MESSAGE_TRAILER_SIZE
+        while pos < end:
+            msgid, param_pos = mp.msgid_parser.parse(s, pos)
+            mid = mp.messages_by_id.get(msgid, mp.unknown)
+            params, pos = mid.parse(s, pos)
+            params['#name'] = mid.name
+            out.append(params)
+    return out
+
+# Parse all messages in all blocks using the C parser
+def parse_c(mp, cblocks):
+    out = []
+    for cblock, blen in cblocks:
+        pos = msgproto.MESSAGE_HEADER_SIZE
+        end = blen - msgproto.MESSAGE_TRAILER_SIZE
+        while pos < end:
+            params, next_pos = mp.parse_c(cblock, blen, pos)
+            if params is None:
+                # Not supported by C parser - fall back to python parser
+                s = list(cblock[0:blen])
+                msgid, param_pos = mp.msgid_parser.parse(s, pos)
+                mid = mp.messages_by_id.get(msgid, mp.unknown)
+                params, next_pos = mid.parse(s, pos)
+                params['#name'] = mid.name
+            out.append(params)
+            pos = next_pos
+    return out
+
+def run_benchmark(func, mp, blocks, repeat):
+    best_time = res = None
+    for i in range(repeat):
+        start_time = time.perf_counter()
+        res = func(mp, blocks)
+        run_time = time.perf_counter() - start_time
+        if best_time is None or run_time < best_time:
+            best_time = run_time
+    return res, best_time
+
+def main():
+    usage = "%prog [options] <dictionary> <serial data dump>"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-r", "--repeat", type="int", dest="repeat", default=5,
+                    help="number of runs (fastest run is reported)")
+    options, args = opts.parse_args()
+    if len(args) != 2:
+        opts.error("Incorrect number of arguments")
+    dict_filename, data_filename = args
+
+    f = open(dict_filename, 'rb')
+    dictionary = f.read()
+    f.close()
+    mp = msgproto.MessageParser()
+    mp.process_identify(dictionary, decompress=False)
+    ffi_main, ffi_lib = chelper.get_ffi()
+    mp.setup_c_parser(ffi_main, ffi_lib)
+
+    blocks = read_blocks(mp, data_filename)
+    if not blocks:
+        sys.stderr.write("No messages found in data dump\n")
+        sys.exit(-1)
+    cblocks = [(ffi_main.new('uint8_t[]', bytes(b)), len(b)) for b in blocks]
+
+    py_res, py_time = run_benchmark(parse_python, mp, blocks, options.repeat)
+    c_res, c_time = run_benchmark(parse_c, mp, cblocks, options.repeat)
+    if py_res != c_res:
+        sys.stderr.write("Parse results do not match\n")
+        sys.exit(-1)
+    count = len(py_res)
+    print("%d blocks, %d messages" % (len(blocks), count))
+    print("%-8s %12s %14s" % ("parser", "us/message", "messages/sec"))
+    for name, run_time in [("python", py_time), ("c", c_time)]:
+        print("%-8s %12.3f %14.0f" % (name, run_time * 1000000. / count,
+                                      count / run_time))
+
+if __name__ == '__main__':
+    main()
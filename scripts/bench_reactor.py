@@ -0,0 +1,78 @@
+#!/usr/bin/env python
+# Benchmark reactor timer dispatch overhead as the timer count grows
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, time
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+import reactor
+
+REACTORS = {
+    'select': reactor.SelectReactor, 'poll': reactor.PollReactor,
+    'epoll': reactor.EPollReactor, 'c': reactor.CReactor,
+}
+
+# Run one fast timer while 'count' idle timers are registered (idle
+# timers are periodically rescheduled far in the future, as is typical
+# of the many infrequent timers in a running host).  Returns the time
+# spent per fast timer callback.
+def run_benchmark(reactor_class, count, events):
+    r = reactor_class()
+    state = {'remaining': events, 'start': 0.}
+    idle_timers = []
+    def idle_event(eventtime):
+        return eventtime + 1000.
+    for i in range(count):
+        idle_timers.append(r.register_timer(idle_event, r.NOW + 1000. + i))
+    def fast_event(eventtime):
+        state['remaining'] -= 1
+        if not state['remaining']:
+            r.end()
+            return r.NEVER
+        # Reschedule an idle timer (as a typical host module would)
+        if idle_timers:
+            t = idle_timers[state['remaining'] % len(idle_timers)]
+            r.update_timer(t, eventtime + 1000.)
+        return r.NOW
+    def start_event(eventtime):
+        state['start'] = time.process_time()
+        r.register_timer(fast_event, r.NOW)
+        return r.NEVER
+    r.register_timer(start_event, r.NOW)
+    r.run()
+    run_time = time.process_time() - state['start']
+    r.finalize()
+    return run_time / events
+
+def main():
+    usage = "%prog [options]"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-r", "--reactor", type="choice", dest="reactor",
+                    choices=sorted(REACTORS.keys()), default="poll",
+                    help="reactor implementation to benchmark")
+    opts.add_option("-n", "--events", type="int", dest="events",
+                    default=20000, help="number of timer events per run")
+    opts.add_option("-c", "--check", type="float", dest="check",
+                    default=0., help="fail if overhead at the largest timer"
+                    " count exceeds this multiple of the smallest")
+    options, args = opts.parse_args()
+    if args:
+        opts.error("Incorrect number of arguments")
+    reactor_class = REACTORS[options.reactor]
+
+    counts = [0, 10, 100, 1000, 10000]
+    results = []
+    print("%-8s %14s" % ("timers", "us/event"))
+    for count in counts:
+        run_time = min([run_benchmark(reactor_class, count, options.events)
+                        for i in range(3)])
+        results.append(run_time)
+        print("%-8d %14.3f" % (count, run_time * 1000000.))
+    if options.check and results[-1] > results[0] * options.check:
+        sys.stderr.write("Timer overhead grows with timer count\n")
+        sys.exit(-1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+# Benchmark step compression using step queues recorded by data_logger.py
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, time
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             'motan'))
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+import readlog, chelper
+
+
+######################################################################
+# Log parsing
+######################################################################
+
+class StepperQueue:
+    def __init__(self, name):
+        self.name = name
+        self.step_clocks = []
+        self.step_dirs = []
+        self.queue_steps = 0
+        self.first_clock = self.last_clock = None
+        self.first_time = self.last_time = 0.
+    def add_block(self, jmsg):
+        if self.first_clock is None:
+            self.first_clock = jmsg['first_clock'] - jmsg['data'][0][0]
+            self.first_time = jmsg['first_step_time']
+        self.last_clock = jmsg['last_clock']
+        self.last_time = jmsg['last_step_time']
+        # Expand queue_step commands into individual step clocks
+        step_clock = jmsg['first_clock'] - jmsg['data'][0][0]
+        step_clocks = self.step_clocks
+        step_dirs = self.step_dirs
+        for interval, raw_count, add in jmsg['data']:
+            if not raw_count:
+                continue
+            self.queue_steps += 1
+            sdir = raw_count > 0
+            for i in range(abs(raw_count)):
+                step_clock += interval
+                interval += add
+                step_clocks.append(step_clock - self.first_clock)
+                step_dirs.append(sdir)
+    def get_mcu_freq(self):
+        if not self.step_clocks or self.last_time <= self.first_time:
+            return None
+        return ((self.last_clock - self.first_clock)
+                / (self.last_time - self.first_time))
+
+def read_log(log_prefix, stepper_names):
+    steppers = {}
+    log_reader = readlog.JsonLogReader(log_prefix + ".json.gz")
+    while 1:
+        jmsg = log_reader.pull_msg()
+        if jmsg is None:
+            break
+        qid = jmsg.get('q', '')
+        if not qid.startswith('stepq:'):
+            continue
+        name = qid[6:]
+        if stepper_names and name not in stepper_names:
+            continue
+        params = jmsg.get('params', {})
+        if not params.get('data'):
+            continue
+        sq = steppers.get(name)
+        if sq is None:
+            sq = steppers[name] = StepperQueue(name)
+        sq.add_block(params)
+    return [steppers[n] for n in sorted(steppers)]
+
+
+######################################################################
+# Benchmark
+######################################################################
+
+def run_benchmark(sq, max_error_time, lookahead, repeat):
+    ffi_main, ffi_lib = chelper.get_ffi()
+    count = len(sq.step_clocks)
+    mcu_freq = sq.get_mcu_freq()
+    if mcu_freq is None:
+        return None
+    max_error = int(max_error_time * mcu_freq)
+    step_clocks = ffi_main.new("uint64_t[]", sq.step_clocks)
+    step_dirs = ffi_main.new("uint8_t[]", sq.step_dirs)
+    best_time = None
+    for i in range(repeat):
+        start_time = time.perf_counter()
+        res = ffi_lib.stepcompress_replay(max_error, lookahead, step_clocks,
+                                          step_dirs, count)
+        run_time = time.perf_counter() - start_time
+        if res < 0:
+            raise Exception("Step compression error %d on %s"
+                            % (res, sq.name))
+        if best_time is None or run_time < best_time:
+            best_time = run_time
+    return res, best_time
+
+def main():
+    usage = "%prog [options] <logname>"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-s", "--stepper", type="string", dest="steppers",
+                    action="append", default=[],
+                    help="only benchmark the given stepper (may be repeated)")
+    opts.add_option("-e", "--max-error", type="float", dest="max_error",
+                    default=0.000025, help="maximum step time error (s)")
+    opts.add_option("-l", "--lookahead", type="int", dest="lookahead",
+                    default=0, help="split points to evaluate per command")
+    opts.add_option("-r", "--repeat", type="int", dest="repeat", default=5,
+                    help="number of runs (fastest run is reported)")
+    options, args = opts.parse_args()
+    if len(args) != 1:
+        opts.error("Incorrect number of arguments")
+    log_prefix = args[0]
+    if log_prefix.endswith(".json.gz"):
+        log_prefix = log_prefix[:-8]
+
+    steppers = read_log(log_prefix, options.steppers)
+    if not steppers:
+        sys.stderr.write("No step queue data found in log\n")
+        sys.exit(-1)
+    print("%-16s %10s %9s %9s %9s %10s %12s" % (
+        "stepper", "steps", "recorded", "replayed", "steps/cmd",
+        "ns/step", "cmds/second"))
+    total_steps = total_cmds = total_time = 0
+    for sq in steppers:
+        result = run_benchmark(sq, options.max_error, options.lookahead,
+                               options.repeat)
+        if result is None:
+            continue
+        cmds, run_time = result
+        steps = len(sq.step_clocks)
+        print("%-16s %10d %9d %9d %9.2f %10.1f %12.0f" % (
+            sq.name, steps, sq.queue_steps, cmds, float(steps) / cmds,
+            run_time * 1000000000. / steps, cmds / run_time))
+        total_steps += steps
+        total_cmds += cmds
+        total_time += run_time
+    if total_steps and total_cmds:
+        print("%-16s %10d %9s %9d %9.2f %10.1f %12.0f" % (
+            "total", total_steps, "", total_cmds,
+            float(total_steps) / total_cmds,
+            total_time * 1000000000. / total_steps, total_cmds / total_time))
+
+if __name__ == '__main__':
+    main()
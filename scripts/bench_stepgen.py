@@ -0,0 +1,378 @@
+#!/usr/bin/env python
+# Benchmark host step generation using trapq moves recorded by data_logger.py
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, math, re, time
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             'motan'))
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy', 'extras'))
+import readlog, chelper, shaper_defs
+
+MCU_FREQ = 16000000.
+STEP_DIST = .0125
+RADIAN_STEP_DIST = 2. * math.pi / (200. * 16. * 5.)
+EXTRUDER_STEP_DIST = .0025
+STEPCOMPRESS_FLUSH_TIME = 0.050
+
+
+######################################################################
+# Move parsing
+######################################################################
+
+# Each move is stored as (print_time, move_t, start_v, accel,
+# (start_x, start_y, start_z), (x_r, y_r, z_r))
+
+MOVE_TIME_ROUNDING = 0.000010
+
+def add_moves(moves, new_moves):
+    last_end_time = moves[-1][0] + moves[-1][1] if moves else -1.
+    for m in new_moves:
+        if m[0] < last_end_time - MOVE_TIME_ROUNDING:
+            # The data logger may report a move more than once
+            continue
+        if m[0] < last_end_time + MOVE_TIME_ROUNDING:
+            # Avoid small gaps or overlaps from rounded log values
+            m = (last_end_time,) + tuple(m[1:])
+        moves.append(m)
+        last_end_time = m[0] + m[1]
+
+def read_json_log(log_prefix):
+    trapqs = {}
+    log_reader = readlog.JsonLogReader(log_prefix + ".json.gz")
+    while 1:
+        jmsg = log_reader.pull_msg()
+        if jmsg is None:
+            break
+        qid = jmsg.get('q', '')
+        if not qid.startswith('trapq:'):
+            continue
+        data = jmsg.get('params', {}).get('data')
+        if data:
+            add_moves(trapqs.setdefault(qid[6:], []),
+                      [(m[0], m[1], m[2], m[3], tuple(m[4]), tuple(m[5]))
+                       for m in data])
+    return trapqs
+
+# Parse the "Dumping trapq" output of a klippy log (eg, after a shutdown)
+def read_klippy_log(logname):
+    trapqs = {}
+    cur_moves = None
+    dump_r = re.compile(r"^Dumping trapq '(?P<name>[^']*)' [0-9]+ moves:$")
+    move_r = re.compile(
+        r"^move [0-9]+: pt=(?P<pt>[^ ]+) mt=(?P<mt>[^ ]+) sv=(?P<sv>[^ ]+)"
+        r" a=(?P<a>[^ ]+) sp=\((?P<sp>[^)]*)\) ar=\((?P<ar>[^)]*)\)$")
+    f = open(logname, 'r')
+    for line in f:
+        line = line.strip()
+        m = dump_r.match(line)
+        if m is not None:
+            cur_moves = trapqs.setdefault(m.group('name'), [])
+            continue
+        m = move_r.match(line)
+        if m is None:
+            cur_moves = None
+            continue
+        if cur_moves is None:
+            continue
+        sp = tuple([float(v) for v in m.group('sp').split(',')])
+        ar = tuple([float(v) for v in m.group('ar').split(',')])
+        add_moves(cur_moves, [(float(m.group('pt')), float(m.group('mt')),
+                               float(m.group('sv')), float(m.group('a')),
+                               sp, ar)])
+    f.close()
+    return trapqs
+
+def read_moves(logname):
+    if logname.endswith(".json.gz"):
+        return read_json_log(logname[:-8])
+    if os.path.exists(logname + ".json.gz"):
+        return read_json_log(logname)
+    return read_klippy_log(logname)
+
+# Create extruder moves from toolhead moves (for logs without extrusion)
+EXTRUDE_RATIO = 0.040
+def extrude_moves(toolhead_moves):
+    out = []
+    e_pos = 0.
+    for pt, mt, sv, a, sp, ar in toolhead_moves:
+        e_r = EXTRUDE_RATIO * math.sqrt(ar[0]**2 + ar[1]**2)
+        if not e_r:
+            continue
+        out.append((pt, mt, sv * e_r, a * e_r, (e_pos, 0., 0.), (1., 1., 0.)))
+        e_pos += (sv + .5 * a * mt) * mt * e_r
+    return out
+
+# Recenter the moves so the xy print area is centered on the origin
+def center_moves(moves):
+    min_x = min(m[4][0] for m in moves)
+    max_x = max(m[4][0] for m in moves)
+    min_y = min(m[4][1] for m in moves)
+    max_y = max(m[4][1] for m in moves)
+    cx, cy = .5 * (min_x + max_x), .5 * (min_y + max_y)
+    out = [(pt, mt, sv, a, (sp[0] - cx, sp[1] - cy, sp[2]), ar)
+           for pt, mt, sv, a, sp, ar in moves]
+    radius = max([math.sqrt(m[4][0]**2 + m[4][1]**2) for m in out] + [1.])
+    max_z = max([m[4][2] for m in out] + [1.])
+    return out, radius, max_z
+
+
+######################################################################
+# Kinematics setup
+######################################################################
+
+# Each function returns a list of (name, stepper_kinematics, step_dist)
+# using the geometry of the moves ('bench.radius' and 'bench.max_z').
+# Any stepper_kinematics that is wrapped by another must be registered
+# with bench.keep() so that it is not freed while in use.
+
+def setup_cartesian(ffi_main, ffi_lib, bench):
+    return [(a, ffi_lib.cartesian_stepper_alloc(a.encode()), STEP_DIST)
+            for a in 'xyz']
+
+def setup_corexy(ffi_main, ffi_lib, bench):
+    return [('a', ffi_lib.corexy_stepper_alloc(b'+'), STEP_DIST),
+            ('b', ffi_lib.corexy_stepper_alloc(b'-'), STEP_DIST),
+            ('z', ffi_lib.cartesian_stepper_alloc(b'z'), STEP_DIST)]
+
+def setup_corexz(ffi_main, ffi_lib, bench):
+    return [('a', ffi_lib.corexz_stepper_alloc(b'+'), STEP_DIST),
+            ('b', ffi_lib.corexz_stepper_alloc(b'-'), STEP_DIST),
+            ('y', ffi_lib.cartesian_stepper_alloc(b'y'), STEP_DIST)]
+
+def setup_generic_cartesian(ffi_main, ffi_lib, bench):
+    return [('a', ffi_lib.generic_cartesian_stepper_alloc(1., 1., 0.),
+             STEP_DIST),
+            ('b', ffi_lib.generic_cartesian_stepper_alloc(1., -1., 0.),
+             STEP_DIST),
+            ('z', ffi_lib.generic_cartesian_stepper_alloc(0., 0., 1.),
+             STEP_DIST)]
+
+def setup_delta(ffi_main, ffi_lib, bench):
+    radius = bench.radius
+    tower_radius = radius + 50.
+    arm = 2. * (tower_radius + radius)
+    res = []
+    for i, angle in enumerate([210., 330., 90.]):
+        a = math.radians(angle)
+        sk = ffi_lib.delta_stepper_alloc(arm**2, math.cos(a) * tower_radius,
+                                         math.sin(a) * tower_radius)
+        res.append(('abc'[i], sk, STEP_DIST))
+    return res
+
+def setup_deltesian(ffi_main, ffi_lib, bench):
+    arm_x = bench.radius + 50.
+    arm = 2. * (arm_x + bench.radius)
+    return [('left', ffi_lib.deltesian_stepper_alloc(arm**2, -arm_x),
+             STEP_DIST),
+            ('right', ffi_lib.deltesian_stepper_alloc(arm**2, arm_x),
+             STEP_DIST),
+            ('y', ffi_lib.cartesian_stepper_alloc(b'y'), STEP_DIST)]
+
+def setup_polar(ffi_main, ffi_lib, bench):
+    return [('bed', ffi_lib.polar_stepper_alloc(b'a'), RADIAN_STEP_DIST),
+            ('arm', ffi_lib.polar_stepper_alloc(b'r'), STEP_DIST),
+            ('z', ffi_lib.cartesian_stepper_alloc(b'z'), STEP_DIST)]
+
+def setup_rotary_delta(ffi_main, ffi_lib, bench):
+    # Scale the geometry of example-rotary-delta.cfg to fit the moves
+    scale = max(1., bench.radius / 100., bench.max_z / 150.)
+    res = []
+    for i, angle in enumerate([30., 150., 270.]):
+        sk = ffi_lib.rotary_delta_stepper_alloc(
+            33.9 * scale, 412.9 * scale, math.radians(angle),
+            170. * scale, 320. * scale)
+        res.append(('abc'[i], sk, RADIAN_STEP_DIST))
+    return res
+
+def setup_winch(ffi_main, ffi_lib, bench):
+    dist = 2. * bench.radius + 100.
+    height = bench.max_z + 100.
+    anchors = [(0., dist, height), (dist, -dist, height),
+               (-dist, -dist, height), (0., 0., height + dist)]
+    return [('abcd'[i], ffi_lib.winch_stepper_alloc(*a), STEP_DIST)
+            for i, a in enumerate(anchors)]
+
+def setup_idex(ffi_main, ffi_lib, bench):
+    res = []
+    for name, scale, offset in [('x', 1., 0.),
+                                ('dc', -1., 2. * bench.radius)]:
+        orig_sk = bench.keep(ffi_lib.cartesian_stepper_alloc(b'x'))
+        sk = ffi_lib.dual_carriage_alloc()
+        ffi_lib.dual_carriage_set_sk(sk, orig_sk)
+        ffi_lib.dual_carriage_set_transform(sk, b'x', scale, offset)
+        ffi_lib.dual_carriage_set_transform(sk, b'y', 1., 0.)
+        res.append((name, sk, STEP_DIST))
+    res.append(('y', ffi_lib.cartesian_stepper_alloc(b'y'), STEP_DIST))
+    return res
+
+def setup_shaper(ffi_main, ffi_lib, bench):
+    A, T = shaper_defs.get_mzv_shaper(50., shaper_defs.DEFAULT_DAMPING_RATIO)
+    res = []
+    for axis in 'xy':
+        orig_sk = bench.keep(ffi_lib.cartesian_stepper_alloc(axis.encode()))
+        sk = ffi_lib.input_shaper_alloc()
+        ffi_lib.input_shaper_set_sk(sk, orig_sk)
+        for saxis in 'xy':
+            ffi_lib.input_shaper_set_shaper_params(sk, saxis.encode(),
+                                                   len(A), A, T)
+        res.append((axis, sk, STEP_DIST))
+    return res
+
+def setup_extruder(ffi_main, ffi_lib, bench):
+    sk = bench.keep(ffi_lib.extruder_stepper_alloc(),
+                    ffi_lib.extruder_stepper_free)
+    ffi_lib.extruder_set_pressure_advance(sk, 0., .040, .040)
+    return [('e', sk, EXTRUDER_STEP_DIST)]
+
+# Kinematics to benchmark (name, setup function, source trapq)
+Kinematics = [
+    ('cartesian', setup_cartesian, 'toolhead'),
+    ('corexy', setup_corexy, 'toolhead'),
+    ('corexz', setup_corexz, 'toolhead'),
+    ('generic_cartesian', setup_generic_cartesian, 'toolhead'),
+    ('delta', setup_delta, 'toolhead'),
+    ('deltesian', setup_deltesian, 'toolhead'),
+    ('polar', setup_polar, 'toolhead'),
+    ('rotary_delta', setup_rotary_delta, 'toolhead'),
+    ('winch', setup_winch, 'toolhead'),
+    ('idex', setup_idex, 'toolhead'),
+    ('shaper', setup_shaper, 'toolhead'),
+    ('extruder', setup_extruder, 'extruder'),
+]
+
+
+######################################################################
+# Benchmark
+######################################################################
+
+class StepGenBench:
+    def __init__(self, moves, radius, max_z, options):
+        self.moves = moves
+        self.radius = radius
+        self.max_z = max_z
+        self.chunk_time = options.chunk_time
+        self.max_error = int(options.max_error * MCU_FREQ)
+        self.lookahead = options.lookahead
+        self.refs = []
+    def keep(self, obj, free_func=None):
+        ffi_main, ffi_lib = chelper.get_ffi()
+        if free_func is None:
+            free_func = ffi_lib.free
+        obj = ffi_main.gc(obj, free_func)
+        self.refs.append(obj)
+        return obj
+    def run(self, setup_func):
+        ffi_main, ffi_lib = chelper.get_ffi()
+        # Create trapq
+        trapq = ffi_main.gc(ffi_lib.trapq_alloc(), ffi_lib.trapq_free)
+        for pt, mt, sv, a, sp, ar in self.moves:
+            ffi_lib.trapq_append(trapq, pt, mt, 0., 0., sp[0], sp[1], sp[2],
+                                 ar[0], ar[1], ar[2], sv, 0., a)
+        # Create step generation objects
+        ssm = ffi_main.gc(ffi_lib.steppersyncmgr_alloc(1),
+                          ffi_lib.steppersyncmgr_free)
+        ss = ffi_lib.steppersyncmgr_alloc_steppersync(ssm)
+        steppers = []
+        kin_flush_delay = 0.
+        start_pos = self.moves[0][4]
+        for name, sk, step_dist in setup_func(ffi_main, ffi_lib, self):
+            if sk not in self.refs:
+                sk = self.keep(sk)
+            se = ffi_lib.steppersync_alloc_syncemitter(ss, name.encode(), 1)
+            sc = ffi_lib.syncemitter_get_stepcompress(se)
+            ffi_lib.stepcompress_fill(sc, len(steppers), self.max_error, 0, 0)
+            ffi_lib.stepcompress_set_lookahead(sc, self.lookahead)
+            ffi_lib.syncemitter_set_stepper_kinematics(se, sk)
+            ffi_lib.itersolve_set_trapq(sk, trapq, step_dist)
+            ffi_lib.itersolve_set_position(sk, *start_pos)
+            kin_flush_delay = max(
+                kin_flush_delay, ffi_lib.itersolve_get_gen_steps_pre_active(sk),
+                ffi_lib.itersolve_get_gen_steps_post_active(sk))
+            steppers.append((se, sc, sk))
+        ffi_lib.steppersync_set_time(ss, 0., MCU_FREQ)
+        # Generate steps
+        gen_steps = ffi_lib.syncemitter_bench_gen_steps
+        finalize_moves = ffi_lib.trapq_finalize_moves
+        end_time = self.moves[-1][0] + self.moves[-1][1] + kin_flush_delay
+        gen_time = self.moves[0][0]
+        latencies = []
+        while 1:
+            gen_time = min(gen_time + self.chunk_time, end_time)
+            flush_clock = int((gen_time - STEPCOMPRESS_FLUSH_TIME) * MCU_FREQ)
+            if gen_time >= end_time:
+                flush_clock = 0xffffffffffffffff
+            start_time = time.perf_counter()
+            for se, sc, sk in steppers:
+                ret = gen_steps(se, gen_time, flush_clock)
+                if ret < 0:
+                    raise Exception("Step generation error %d" % (ret,))
+            free_time = gen_time - kin_flush_delay
+            finalize_moves(trapq, free_time, free_time - 1.)
+            latencies.append(time.perf_counter() - start_time)
+            if gen_time >= end_time:
+                break
+        # Gather results
+        stats = ffi_main.new('struct stepcompress_stats *')
+        steps = cmds = 0
+        for se, sc, sk in steppers:
+            ffi_lib.stepcompress_get_stats(sc, stats)
+            steps += stats.step_count
+            cmds += stats.queue_step_count
+        return steps, cmds, latencies
+
+def percentile(sorted_vals, pct):
+    pos = min(len(sorted_vals) - 1, int(len(sorted_vals) * pct))
+    return sorted_vals[pos]
+
+def main():
+    usage = "%prog [options] <logname>"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-k", "--kinematics", type="string", dest="kinematics",
+                    action="append", default=[],
+                    help="only benchmark the given kinematics"
+                    " (may be repeated)")
+    opts.add_option("-c", "--chunk-time", type="float", dest="chunk_time",
+                    default=0.250, help="print time generated per batch (s)")
+    opts.add_option("-e", "--max-error", type="float", dest="max_error",
+                    default=0.000025, help="maximum step time error (s)")
+    opts.add_option("-l", "--lookahead", type="int", dest="lookahead",
+                    default=0, help="stepcompress split points to evaluate")
+    options, args = opts.parse_args()
+    if len(args) != 1:
+        opts.error("Incorrect number of arguments")
+    trapqs = read_moves(args[0])
+    for name in options.kinematics:
+        if name not in [k[0] for k in Kinematics]:
+            opts.error("Unknown kinematics '%s'" % (name,))
+
+    print("%-18s %10s %9s %10s %11s %8s %8s %8s %8s" % (
+        "kinematics", "steps", "cmds", "steps/sec", "cmds/sec",
+        "p50(ms)", "p90(ms)", "p99(ms)", "max(ms)"))
+    for kin_name, setup_func, tq_name in Kinematics:
+        if options.kinematics and kin_name not in options.kinematics:
+            continue
+        moves = trapqs.get(tq_name)
+        if not moves:
+            if tq_name == 'extruder' and trapqs.get('toolhead'):
+                moves = extrude_moves(trapqs['toolhead'])
+            if not moves:
+                print("%-18s (no '%s' moves in log)" % (kin_name, tq_name))
+                continue
+        moves, radius, max_z = center_moves(moves)
+        bench = StepGenBench(moves, radius, max_z, options)
+        steps, cmds, latencies = bench.run(setup_func)
+        total_time = sum(latencies)
+        latencies.sort()
+        print("%-18s %10d %9d %10.0f %11.0f %8.3f %8.3f %8.3f %8.3f" % (
+            kin_name, steps, cmds, steps / total_time, cmds / total_time,
+            percentile(latencies, .50) * 1000.,
+            percentile(latencies, .90) * 1000.,
+            percentile(latencies, .99) * 1000., latencies[-1] * 1000.))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python
+# Check that batched stepper commands describe the same moves as queue_step
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, json, subprocess, tempfile, shutil
+import bench_mcu_steps
+
+# Commands that the host uses in place of queue_step when available
+BATCH_COMMANDS = [
+    "queue_steps data=%*s",
+    "queue_step_delta oid=%c interval=%i count=%hu add=%hi",
+    "queue_steps_delta data=%*s",
+]
+
+class error(Exception):
+    pass
+
+def parse_test(fname):
+    # Extract the config, dictionary, and g-code of a test case
+    config_fname = dict_fname = None
+    gcode = []
+    f = open(fname, 'r')
+    for line in f:
+        cpos = line.find('#')
+        if cpos >= 0:
+            line = line[:cpos]
+        parts = line.strip().split()
+        if not parts:
+            continue
+        if parts[0] == "CONFIG":
+            config_fname = os.path.join(os.path.dirname(fname), parts[1])
+        elif parts[0] == "DICTIONARY":
+            if len(parts) != 2:
+                raise error("Only a single mcu is supported")
+            dict_fname = parts[1]
+        else:
+            gcode.append(line.strip())
+    f.close()
+    if config_fname is None or dict_fname is None:
+        raise error("Test case must specify a config and dictionary")
+    return config_fname, dict_fname, gcode
+
+def run_klippy(config_fname, dict_fname, gcode_fname, output_fname):
+    log_fname = output_fname + ".log"
+    args = [sys.executable, './klippy/klippy.py', config_fname,
+            '-i', gcode_fname, '-o', output_fname, '-d', dict_fname,
+            '-l', log_fname]
+    if subprocess.call(args):
+        f = open(log_fname, 'r')
+        sys.stdout.write(f.read())
+        f.close()
+        raise error("Error during klippy run with %s" % (dict_fname,))
+
+def read_moves(dict_fname, output_fname):
+    # Decode the step commands the same way the mcu does
+    config_cmds, step_cmds = bench_mcu_steps.read_output(dict_fname,
+                                                         output_fname)
+    moves = {}
+    counts = {}
+    for msgformat, params, cmd_moves, reset_oid in step_cmds:
+        name = msgformat.split()[0]
+        counts[name] = counts.get(name, 0) + 1
+        for oid, first_clock, last_clock in cmd_moves:
+            moves.setdefault(oid, []).append((first_clock, last_clock))
+    return moves, counts
+
+def check_test(test_fname, dictdir, tempdir):
+    config_fname, dict_fname, gcode = parse_test(test_fname)
+    dict_fname = os.path.join(dictdir, dict_fname)
+    f = open(dict_fname, 'r')
+    dictionary = json.load(f)
+    f.close()
+    commands = dictionary['commands']
+    batch_cmds = [c for c in BATCH_COMMANDS if c in commands]
+    if not batch_cmds:
+        raise error("Dictionary %s does not support batched step commands"
+                    % (dict_fname,))
+    # Create a dictionary without the batched commands
+    plain_dict_fname = os.path.join(tempdir, "plain.dict")
+    for c in BATCH_COMMANDS:
+        commands.pop(c, None)
+    f = open(plain_dict_fname, 'w')
+    json.dump(dictionary, f)
+    f.close()
+    gcode_fname = os.path.join(tempdir, "test.gcode")
+    f = open(gcode_fname, 'w')
+    f.write('\n'.join(gcode + ['']))
+    f.close()
+    # Generate and decode the output of both dictionaries
+    results = []
+    for name, dfname in [("batch", dict_fname), ("plain", plain_dict_fname)]:
+        output_fname = os.path.join(tempdir, name + ".output")
+        run_klippy(config_fname, dfname, gcode_fname, output_fname)
+        results.append(read_moves(dfname, output_fname))
+    (batch_moves, batch_counts), (plain_moves, plain_counts) = results
+    if not [c for c in batch_cmds if batch_counts.get(c.split()[0])]:
+        raise error("No batched step commands generated")
+    if sorted(batch_moves.keys()) != sorted(plain_moves.keys()):
+        raise error("Stepper oids differ")
+    for oid in sorted(plain_moves.keys()):
+        bm, pm = batch_moves[oid], plain_moves[oid]
+        for i, (b, p) in enumerate(zip(bm, pm)):
+            if b != p:
+                raise error("Stepper oid %d move %d differs: %s vs %s"
+                            % (oid, i, b, p))
+        if len(bm) != len(pm):
+            raise error("Stepper oid %d has %d moves instead of %d"
+                        % (oid, len(bm), len(pm)))
+    sys.stdout.write("%s: %d moves match (%s)\n" % (
+        test_fname, sum([len(m) for m in plain_moves.values()]),
+        " ".join(["%s=%d" % (n, c) for n, c in sorted(batch_counts.items())])))
+
+def main():
+    usage = "%prog [options] <test cases>"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-d", "--dictdir", dest="dictdir", default=".",
+                    help="directory for dictionary files")
+    options, args = opts.parse_args()
+    if len(args) < 1:
+        opts.error("Incorrect number of arguments")
+    for fname in args:
+        tempdir = tempfile.mkdtemp()
+        try:
+            check_test(fname, options.dictdir, tempdir)
+        except error as e:
+            sys.stderr.write("\n\nTest case %s FAILED (%s)!\n\n" % (fname, e))
+            sys.exit(-1)
+        finally:
+            shutil.rmtree(tempdir)
+
+if __name__ == '__main__':
+    main()
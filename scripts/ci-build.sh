@@ -81,3 +81,11 @@ finish_test klippy "Test invoke klippy (Python3)"
 start_test klippy "Test invoke klippy (Python2)"
 $PYTHON2 scripts/test_klippy.py -d ${DICTDIR} test/klippy/*.test
 finish_test klippy "Test invoke klippy (Python2)"
+
+start_test klippy "Test invoke klippy (C reactor)"
+$PYTHON scripts/test_klippy.py --c-reactor -d ${DICTDIR} test/klippy/*.test
+finish_test klippy "Test invoke klippy (C reactor)"
+
+start_test klippy "Test batched stepper commands"
+$PYTHON scripts/check_step_batching.py -d ${DICTDIR} test/klippy/linuxtest.test
+finish_test klippy "Test batched stepper commands"
@@ -0,0 +1,117 @@
+#!/usr/bin/env python
+# Convert a g-code file into a pre-parsed file for virtual_sdcard
+#
+# Copyright (C) 2026  The Klipper developers
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+import sys, os, optparse, struct, decimal
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '..', 'klippy'))
+import chelper
+from extras import virtual_sdcard
+
+# Commands stored in tokenized form (others are stored as text)
+DEFAULT_COMMANDS = "G0,G1,G92,M204"
+
+# Number of lines passed to the C tokenizer at a time
+BATCH_LINES = 1024
+
+MAX_TEXT_LEN = virtual_sdcard.READ_SIZE - 6
+
+# Value encoding (see klippy/chelper/gcodeparse.c)
+MAX_SCALE = 22
+RAW_DOUBLE = 0xff
+
+def get_command_code(cmd):
+    return (ord(cmd[0]) << 16) | int(cmd[1:])
+
+# Encode an unsigned integer as a varint (7 bits per byte, low bits first)
+def encode_varint(v):
+    out = []
+    while v >= 0x80:
+        out.append((v & 0x7f) | 0x80)
+        v >>= 7
+    out.append(v)
+    return bytes(bytearray(out))
+
+# Store a value as a decimal mantissa and scale if that exactly
+# reproduces the value (otherwise store the raw double)
+def encode_value(value):
+    raw = struct.pack('<d', value)
+    sign, digits, exp = decimal.Decimal(repr(value)).as_tuple()
+    if isinstance(exp, int) and -exp <= MAX_SCALE:
+        mantissa = int(''.join(map(str, digits)))
+        scale = -exp
+        if scale < 0:
+            mantissa *= 10**-scale
+            scale = 0
+        if sign:
+            mantissa = -mantissa
+        if (abs(mantissa) < 2**53
+            and struct.pack('<d', mantissa / float(10**scale)) == raw):
+            zigzag = (mantissa << 1) ^ (mantissa >> 63)
+            return struct.pack('<B', scale) + encode_varint(zigzag)
+    return struct.pack('<B', RAW_DOUBLE) + raw
+
+def encode_token(token):
+    mask = token.param_mask
+    values = [encode_value(token.values[i])
+              for i in range(26) if mask & (1 << i)]
+    return struct.pack('<II', token.code, mask) + b"".join(values)
+
+def encode_text(line):
+    data = line.encode()
+    if len(data) > MAX_TEXT_LEN:
+        raise ValueError("Line too long: %s..." % (line[:40],))
+    return struct.pack('<IH', 0, len(data)) + data
+
+def convert(lines, codes, outfile):
+    ffi_main, ffi_lib = chelper.get_ffi()
+    tokens = ffi_main.new('struct gcodeparse_line[]', BATCH_LINES)
+    outfile.write(virtual_sdcard.PREPARSED_HEADER)
+    token_count = text_count = 0
+    for start in range(0, len(lines), BATCH_LINES):
+        batch = lines[start:start+BATCH_LINES]
+        data = '\n'.join(batch).encode()
+        ffi_lib.gcodeparse_lines(data, len(data), tokens, len(batch))
+        for i, line in enumerate(batch):
+            token = tokens[i]
+            if token.code in codes:
+                outfile.write(encode_token(token))
+                token_count += 1
+            else:
+                outfile.write(encode_text(line))
+                text_count += 1
+    return token_count, text_count
+
+def main():
+    usage = "%prog [options] <input.gcode> <output." \
+            + virtual_sdcard.PREPARSED_EXT + ">"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-c", "--commands", type="string", dest="commands",
+                    default=DEFAULT_COMMANDS,
+                    help="comma separated list of commands to tokenize")
+    options, args = opts.parse_args()
+    if len(args) != 2:
+        opts.error("Incorrect number of arguments")
+    infilename, outfilename = args
+    codes = set([get_command_code(cmd.strip().upper())
+                 for cmd in options.commands.split(',')])
+
+    f = open(infilename, 'rb')
+    data = f.read().decode()
+    f.close()
+    # Comments and blank lines are not stored.  An unterminated final
+    # line is ignored (as it is when printing the original file).
+    lines = [line for line in data.split('\n')[:-1]
+             if line.strip() and not line.strip().startswith(';')]
+
+    f = open(outfilename, 'wb')
+    token_count, text_count = convert(lines, codes, f)
+    out_size = f.tell()
+    f.close()
+    print("%d lines: %d tokenized, %d text (%d -> %d bytes)" % (
+        len(lines), token_count, text_count, len(data.encode()), out_size))
+
+if __name__ == '__main__':
+    main()
@@ -54,19 +54,35 @@ f4: *p++ = v & 0x7f;
 }
 
 // Parse an integer that was encoded as a "variable length quantity"
+// and that must end before 'end'
 static uint32_t
-parse_int(uint8_t **pp)
+parse_int(uint8_t **pp, uint8_t *end)
 {
-    uint8_t *p = *pp, c = *p++;
+    uint8_t *p = *pp;
+    if (p >= end)
+        goto error;
+    uint8_t c = *p++;
     uint32_t v = c & 0x7f;
     if ((c & 0x60) == 0x60)
         v |= -0x20;
     while (c & 0x80) {
+        if (p >= end)
+            goto error;
         c = *p++;
         v = (v<<7) | (c & 0x7f);
     }
     *pp = p;
     return v;
+error:
+    shutdown("Command parser error");
+}
+
+// Parse an integer from a command data buffer (eg, a "%*s" parameter)
+// that ends at 'end'
+uint32_t
+command_parse_int(uint8_t **pp, uint8_t *end)
+{
+    return parse_int(pp, end);
 }
 
 // Write an encoded msgid (optimized 2-byte VLQ encoder)
@@ -109,7 +125,7 @@ command_parsef(uint8_t *p, uint8_t *maxend
         case PT_uint16:
         case PT_int16:
         case PT_byte:
-            *args++ = parse_int(&p);
+            *args++ = parse_int(&p, maxend);
             break;
         case PT_buffer: {
             uint_fast8_t len = *p++;
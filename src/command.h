@@ -74,6 +74,7 @@ enum {
 
 // command.c
 void *command_decode_ptr(uint32_t v);
+uint32_t command_parse_int(uint8_t **pp, uint8_t *end);
 uint_fast16_t command_parse_msgid(uint8_t **pp);
 uint8_t *command_parsef(uint8_t *p, uint8_t *maxend
                         , const struct command_parser *cp, uint32_t *args);
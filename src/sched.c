@@ -63,6 +63,19 @@ static struct timer sentinel_timer = {
     .waketime = 0x80000000,
 };
 
+// The deleted timer is used when deleting an active timer.
+static uint_fast8_t
+deleted_event(struct timer *t)
+{
+    return SF_DONE;
+}
+
+static struct timer deleted_timer = {
+    .func = deleted_event,
+};
+
+#if !CONFIG_SCHED_TIMER_HEAP
+
 // Find position for a timer in timer_list and insert it
 static void __always_inline
 insert_timer(struct timer *pos, struct timer *t, uint32_t waketime)
@@ -106,17 +119,6 @@ sched_add_timer(struct timer *add)
     irq_restore(flag);
 }
 
-// The deleted timer is used when deleting an active timer.
-static uint_fast8_t
-deleted_event(struct timer *t)
-{
-    return SF_DONE;
-}
-
-static struct timer deleted_timer = {
-    .func = deleted_event,
-};
-
 // Remove a timer that may be live.
 void
 sched_del_timer(struct timer *del)
@@ -189,6 +191,156 @@ sched_timer_reset(void)
     timer_kick();
 }
 
+#else // CONFIG_SCHED_TIMER_HEAP
+
+// When CONFIG_SCHED_TIMER_HEAP is enabled the pending timers are
+// stored in a binary min-heap ordered by waketime (instead of the
+// sorted timer_list) so that the cost of scheduling a timer does not
+// grow linearly with the number of active timers.  The next timer to
+// run is always TimerHeap.list[0].  The deleted_timer takes the place
+// of that first timer in the same way as it does for timer_list.
+
+static struct {
+    struct timer *list[CONFIG_SCHED_TIMER_HEAP_SIZE];
+    uint8_t count;
+} TimerHeap = { .list = { &periodic_timer }, .count = 1 };
+
+// Move a timer towards the start of the heap until the heap is ordered
+static void __always_inline
+heap_sift_up(uint_fast8_t pos, struct timer *t, uint32_t waketime)
+{
+    struct timer **list = TimerHeap.list;
+    while (pos) {
+        uint_fast8_t parent = (pos - 1) / 2;
+        struct timer *p = list[parent];
+        if (!timer_is_before(waketime, p->waketime))
+            break;
+        list[pos] = p;
+        pos = parent;
+    }
+    list[pos] = t;
+}
+
+// Move a timer towards the end of the heap until the heap is ordered
+static void
+heap_sift_down(uint_fast8_t pos, struct timer *t, uint32_t waketime)
+{
+    struct timer **list = TimerHeap.list;
+    uint_fast8_t count = TimerHeap.count;
+    for (;;) {
+        uint_fast8_t child = pos * 2 + 1;
+        if (child >= count)
+            break;
+        struct timer *c = list[child];
+        if (child + 1 < count
+            && timer_is_before(list[child + 1]->waketime, c->waketime))
+            c = list[++child];
+        if (!timer_is_before(c->waketime, waketime))
+            break;
+        list[pos] = c;
+        pos = child;
+    }
+    list[pos] = t;
+}
+
+// Schedule a function call at a supplied time.
+void
+sched_add_timer(struct timer *add)
+{
+    uint32_t waketime = add->waketime;
+    irqstatus_t flag = irq_save();
+    if (unlikely(TimerHeap.count >= CONFIG_SCHED_TIMER_HEAP_SIZE - 1)) {
+        // Always leave room for the deleted_timer
+        try_shutdown("Timer heap full");
+        irq_restore(flag);
+        return;
+    }
+    struct timer *first = TimerHeap.list[0];
+    if (unlikely(timer_is_before(waketime, first->waketime))) {
+        // This timer is before all other scheduled timers
+        if (timer_is_before(waketime, timer_read_time()))
+            try_shutdown("Timer too close");
+        deleted_timer.waketime = waketime;
+        if (first != &deleted_timer)
+            heap_sift_up(TimerHeap.count++, &deleted_timer, waketime);
+        timer_kick();
+    }
+    heap_sift_up(TimerHeap.count++, add, waketime);
+    irq_restore(flag);
+}
+
+// Remove a timer that may be live.
+void
+sched_del_timer(struct timer *del)
+{
+    irqstatus_t flag = irq_save();
+    struct timer **list = TimerHeap.list;
+    if (list[0] == del) {
+        // Deleting the next active timer - replace with deleted_timer
+        deleted_timer.waketime = del->waketime;
+        list[0] = &deleted_timer;
+    } else {
+        // Find and remove from timer heap (if present).  Deleting a
+        // timer is rare, so a linear search is acceptable here.
+        uint_fast8_t pos, count = TimerHeap.count;
+        for (pos = 1; pos < count; pos++) {
+            if (list[pos] != del)
+                continue;
+            struct timer *last = list[--count];
+            TimerHeap.count = count;
+            if (pos >= count)
+                break;
+            uint32_t waketime = last->waketime;
+            if (timer_is_before(waketime, list[(pos - 1) / 2]->waketime))
+                heap_sift_up(pos, last, waketime);
+            else
+                heap_sift_down(pos, last, waketime);
+            break;
+        }
+    }
+    irq_restore(flag);
+}
+
+// Invoke the next timer - called from board hardware irq code.
+unsigned int
+sched_timer_dispatch(void)
+{
+    // Invoke timer callback
+    struct timer *t = TimerHeap.list[0];
+    uint_fast8_t res;
+    uint32_t updated_waketime;
+    if (CONFIG_INLINE_STEPPER_HACK && likely(!t->func)) {
+        res = stepper_event(t);
+        updated_waketime = t->waketime;
+    } else {
+        res = t->func(t);
+        updated_waketime = t->waketime;
+    }
+
+    // Update heap (rescheduling current timer if necessary)
+    if (unlikely(res == SF_DONE)) {
+        struct timer *last = TimerHeap.list[--TimerHeap.count];
+        heap_sift_down(0, last, last->waketime);
+    } else {
+        heap_sift_down(0, t, updated_waketime);
+    }
+
+    return TimerHeap.list[0]->waketime;
+}
+
+// Remove all user timers
+void
+sched_timer_reset(void)
+{
+    deleted_timer.waketime = periodic_timer.waketime;
+    TimerHeap.list[0] = &deleted_timer;
+    TimerHeap.list[1] = &periodic_timer;
+    TimerHeap.count = 2;
+    timer_kick();
+}
+
+#endif // CONFIG_SCHED_TIMER_HEAP
+
 
 /****************************************************************
  * Tasks
@@ -6,6 +6,7 @@
 
 #include "autoconf.h" // CONFIG_*
 #include "basecmd.h" // oid_alloc
+#include "board/io.h" // readb
 #include "board/gpio.h" // gpio_out_write
 #include "board/irq.h" // irq_disable
 #include "board/misc.h" // timer_is_before
@@ -27,8 +28,15 @@ DECL_CONSTANT("STEPPER_STEP_BOTH_EDGE", 1);
  #define HAVE_AVR_OPTIMIZATION 0
 #endif
 
+#if CONFIG_STEPPER_MOVE_RING
+ #define MOVE_RING_SIZE CONFIG_STEPPER_MOVE_RING_SIZE
+ DECL_CONSTANT("STEPPER_MOVE_QUEUE", MOVE_RING_SIZE);
+#endif
+
 struct stepper_move {
+#if !CONFIG_STEPPER_MOVE_RING
     struct move_node node;
+#endif
     uint32_t interval;
     int16_t add;
     uint16_t count;
@@ -43,9 +51,17 @@ struct stepper {
     int16_t add;
     uint32_t count;
     uint32_t next_step_time, step_pulse_ticks;
+#if CONFIG_STEPPER_QUEUE_STEP_DELTA
+    uint32_t predict_interval;
+#endif
     struct gpio_out step_pin, dir_pin;
     uint32_t position;
+#if CONFIG_STEPPER_MOVE_RING
+    struct stepper_move moves[MOVE_RING_SIZE];
+    uint8_t move_first, move_next, move_count;
+#else
     struct move_queue_head mq;
+#endif
     struct trsync_signal stop_signal;
     // gcc (pre v6) does better optimization when uint8_t are bitfields
     uint8_t flags : 8;
@@ -58,24 +74,118 @@ enum {
     SF_SINGLE_SCHED=1<<4, SF_OPTIMIZED_PATH=1<<5, SF_HAVE_ADD=1<<6
 };
 
+
+
+/****************************************************************
+ * Stepper move queue
+ ****************************************************************/
+
+// When CONFIG_STEPPER_MOVE_RING is enabled each stepper stores its
+// pending moves in a fixed size ring buffer instead of allocating
+// them from the shared move queue.  The host is informed of the ring
+// size via the STEPPER_MOVE_QUEUE constant.
+
+// Check if the stepper has no pending moves
+static int
+stepper_queue_empty(struct stepper *s)
+{
+#if CONFIG_STEPPER_MOVE_RING
+    return !s->move_count;
+#else
+    return move_queue_empty(&s->mq);
+#endif
+}
+
+// Obtain storage for a new move (must be followed by stepper_queue_push)
+static struct stepper_move *
+stepper_queue_alloc(struct stepper *s)
+{
+#if CONFIG_STEPPER_MOVE_RING
+    // Only task code advances move_next and irq code can only
+    // decrease move_count, so the slot at move_next is known to be
+    // free (without disabling irqs) if move_count is below the size
+    if (readb(&s->move_count) >= MOVE_RING_SIZE)
+        shutdown("Stepper move queue overflow");
+    return &s->moves[s->move_next];
+#else
+    return move_alloc();
+#endif
+}
+
+// Add a move obtained from stepper_queue_alloc() (caller must disable irqs)
+static void
+stepper_queue_push(struct stepper *s, struct stepper_move *m)
+{
+#if CONFIG_STEPPER_MOVE_RING
+    uint_fast8_t pos = s->move_next + 1;
+    s->move_next = pos >= MOVE_RING_SIZE ? 0 : pos;
+    s->move_count++;
+#else
+    move_queue_push(&m->node, &s->mq);
+#endif
+}
+
+// Release a move that was not added to the queue (caller must disable irqs)
+static void
+stepper_queue_free(struct stepper_move *m)
+{
+#if !CONFIG_STEPPER_MOVE_RING
+    move_free(m);
+#endif
+}
+
+// Remove the next move from the queue (caller must ensure queue not
+// empty).  The returned move must be freed with stepper_queue_free().
+static struct stepper_move *
+stepper_queue_pop(struct stepper *s)
+{
+#if CONFIG_STEPPER_MOVE_RING
+    uint_fast8_t pos = s->move_first;
+    s->move_first = pos + 1 >= MOVE_RING_SIZE ? 0 : pos + 1;
+    s->move_count--;
+    return &s->moves[pos];
+#else
+    struct move_node *mn = move_queue_pop(&s->mq);
+    return container_of(mn, struct stepper_move, node);
+#endif
+}
+
+// Discard all pending moves (caller must disable irqs)
+static void
+stepper_queue_clear(struct stepper *s)
+{
+#if CONFIG_STEPPER_MOVE_RING
+    // Leave move_next unchanged as task code may be filling that slot
+    s->move_first = s->move_next;
+    s->move_count = 0;
+#else
+    while (!move_queue_empty(&s->mq))
+        stepper_queue_free(stepper_queue_pop(s));
+#endif
+}
+
+
+/****************************************************************
+ * Step generation
+ ****************************************************************/
+
 // Setup a stepper for the next move in its queue
 static uint_fast8_t
 stepper_load_next(struct stepper *s)
 {
-    if (move_queue_empty(&s->mq)) {
+    if (stepper_queue_empty(s)) {
         // There is no next move - the queue is empty
         s->count = 0;
         return SF_DONE;
     }
 
     // Read next 'struct stepper_move'
-    struct move_node *mn = move_queue_pop(&s->mq);
-    struct stepper_move *m = container_of(mn, struct stepper_move, node);
+    struct stepper_move *m = stepper_queue_pop(s);
     uint32_t move_interval = m->interval;
     uint_fast16_t move_count = m->count;
     int_fast16_t move_add = m->add;
     uint_fast8_t need_dir_change = m->flags & MF_DIR;
-    move_free(m);
+    stepper_queue_free(m);
 
     // Add all steps to s->position (stepper_get_position() can calc mid-move)
     s->position = (need_dir_change ? -s->position : s->position) + move_count;
@@ -229,7 +339,9 @@ command_config_stepper(uint32_t *args)
     s->dir_pin = gpio_out_setup(args[2], 0);
     s->position = -POSITION_BIAS;
     s->step_pulse_ticks = args[4];
+#if !CONFIG_STEPPER_MOVE_RING
     move_queue_setup(&s->mq, sizeof(struct stepper_move));
+#endif
     if (HAVE_EDGE_OPTIMIZATION) {
         if (invert_step < 0 && s->step_pulse_ticks <= EDGE_STEP_TICKS)
             s->flags |= SF_OPTIMIZED_PATH;
@@ -259,13 +371,17 @@ void
 command_queue_step(uint32_t *args)
 {
     struct stepper *s = stepper_oid_lookup(args[0]);
-    struct stepper_move *m = move_alloc();
+    struct stepper_move *m = stepper_queue_alloc(s);
     m->interval = args[1];
     m->count = args[2];
     if (!m->count)
         shutdown("Invalid count parameter");
     m->add = args[3];
     m->flags = 0;
+#if CONFIG_STEPPER_QUEUE_STEP_DELTA
+    // Track the interval a continuation of this move would start with
+    s->predict_interval = m->interval + (int32_t)m->add * m->count;
+#endif
 
     irq_disable();
     uint8_t flags = s->flags;
@@ -275,12 +391,12 @@ command_queue_step(uint32_t *args)
     }
     if (s->count) {
         s->flags = flags;
-        move_queue_push(&m->node, &s->mq);
+        stepper_queue_push(s, m);
     } else if (flags & SF_NEED_RESET) {
-        move_free(m);
+        stepper_queue_free(m);
     } else {
         s->flags = flags;
-        move_queue_push(&m->node, &s->mq);
+        stepper_queue_push(s, m);
         stepper_load_next(s);
         sched_add_timer(&s->time);
     }
@@ -289,6 +405,62 @@ command_queue_step(uint32_t *args)
 DECL_COMMAND(command_queue_step,
              "queue_step oid=%c interval=%u count=%hu add=%hi");
 
+#if CONFIG_STEPPER_QUEUE_STEP_DELTA
+
+// Schedule a set of steps with an interval relative to the last move
+void
+command_queue_step_delta(uint32_t *args)
+{
+    struct stepper *s = stepper_oid_lookup(args[0]);
+    args[1] += s->predict_interval;
+    command_queue_step(args);
+}
+DECL_COMMAND(command_queue_step_delta,
+             "queue_step_delta oid=%c interval=%i count=%hu add=%hi");
+
+#endif
+
+#if CONFIG_STEPPER_QUEUE_STEPS
+
+// Decode a batch of queue_step style entries (each may be for a
+// different stepper)
+static void
+queue_steps_decode(uint32_t *args, void (*queue_func)(uint32_t *))
+{
+    uint8_t data_len = args[0];
+    uint8_t *data = command_decode_ptr(args[1]), *end = &data[data_len];
+    while (data < end) {
+        // Each entry has the same parameters as a queue_step command
+        uint32_t step_args[4];
+        uint_fast8_t i;
+        for (i=0; i<ARRAY_SIZE(step_args); i++)
+            step_args[i] = command_parse_int(&data, end);
+        queue_func(step_args);
+    }
+}
+
+// Schedule several sets of steps
+void
+command_queue_steps(uint32_t *args)
+{
+    queue_steps_decode(args, command_queue_step);
+}
+DECL_COMMAND(command_queue_steps, "queue_steps data=%*s");
+
+#if CONFIG_STEPPER_QUEUE_STEP_DELTA
+
+// Schedule several sets of steps with relative intervals
+void
+command_queue_steps_delta(uint32_t *args)
+{
+    queue_steps_decode(args, command_queue_step_delta);
+}
+DECL_COMMAND(command_queue_steps_delta, "queue_steps_delta data=%*s");
+
+#endif
+
+#endif
+
 // Set the direction of the next queued step
 void
 command_set_next_step_dir(uint32_t *args)
@@ -311,6 +483,9 @@ command_reset_step_clock(uint32_t *args)
     if (s->count)
         shutdown("Can't reset time when stepper active");
     s->next_step_time = s->time.waketime = waketime;
+#if CONFIG_STEPPER_QUEUE_STEP_DELTA
+    s->predict_interval = 0;
+#endif
     s->flags &= ~SF_NEED_RESET;
     irq_enable();
 }
@@ -361,11 +536,7 @@ stepper_stop(struct trsync_signal *tss, uint8_t reason)
         || (HAVE_AVR_OPTIMIZATION && s->flags & SF_OPTIMIZED_PATH))
         // Must return step pin to "unstep" state
         gpio_out_write(s->step_pin, s->flags & SF_INVERT_STEP);
-    while (!move_queue_empty(&s->mq)) {
-        struct move_node *mn = move_queue_pop(&s->mq);
-        struct stepper_move *m = container_of(mn, struct stepper_move, node);
-        move_free(m);
-    }
+    stepper_queue_clear(s);
 }
 
 // Set the stepper to stop on a "trigger event" (used in homing)
@@ -385,7 +556,9 @@ stepper_shutdown(void)
     uint8_t i;
     struct stepper *s;
     foreach_oid(i, s, command_config_stepper) {
+#if !CONFIG_STEPPER_MOVE_RING
         move_queue_clear(&s->mq);
+#endif
         stepper_stop(&s->stop_signal, 0);
     }
 }
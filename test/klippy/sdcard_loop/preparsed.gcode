@@ -0,0 +1,15 @@
+; Example used to test pre-parsed g-code files (preparsed.kgc is
+; generated from this file with scripts/preparse_gcode.py)
+G90
+M83
+G1 X10 Y10 Z1 F6000
+M117 Printing pre-parsed file
+G1 X20.5 Y15.25 E0.15
+G1 X30 Y30 E0.2 F3000
+G92 E0
+M204 S1000
+G1 X10.125 Y40 ; comment after a move
+g1 x5 y5
+G1 X50 Y50 Z2 F6000
+G4 P10
+G1 X0 Y0